@@ -0,0 +1,69 @@
+#include "DecompressingDataSource.h"
+#include "GzipDataSink.h"
+#include "StringDataSink.h"
+#include "StringDataSource.h"
+#include "XMLReader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+// Peak resident set size of this process in kB
+long PeakRSS(){
+    std::ifstream Status("/proc/self/status");
+    std::string Line;
+    while(std::getline(Status, Line)){
+        if(Line.compare(0, 6, "VmHWM:") == 0){
+            return std::strtol(Line.c_str() + 6, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+// Writes an SVG shaped document of roughly megabytes MB to sink
+void GenerateDocument(CDataSink &sink, std::size_t megabytes){
+    std::string Block;
+    for(int Index = 0; Block.size() < (1 << 20); Index++){
+        Block += "<circle cx=\"" + std::to_string(Index % 1000) + "\" cy=\"" + std::to_string(Index % 777) + ".5\" r=\"2.5\" style=\"fill:blue\"/>\n";
+    }
+    std::string Head = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg width=\"1000\" height=\"1000\" xmlns=\"http://www.w3.org/2000/svg\">\n<g>\n";
+    std::string Tail = "</g>\n</svg>\n";
+    sink.Write(Head.data(), Head.size());
+    for(std::size_t Index = 0; Index < megabytes; Index++){
+        sink.Write(Block.data(), Block.size());
+    }
+    sink.Write(Tail.data(), Tail.size());
+}
+
+void RunParse(const char *name, std::shared_ptr<CDataSource> source, std::size_t megabytes){
+    auto Start = std::chrono::steady_clock::now();
+    CXMLReader Reader(source);
+    SXMLEntityView Entity;
+    std::size_t Entities = 0;
+    while(Reader.ReadEntityView(Entity, true)){
+        Entities++;
+    }
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::printf("%-22s entities=%zu time=%.3fs MB/s=%.1f peakRSS=%ldkB\n", name, Entities, Elapsed, megabytes / Elapsed, PeakRSS());
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 128;
+
+    // Compressed runs first, while the peak RSS only reflects the .svgz
+    auto Compressed = std::make_shared<CStringDataSink>();
+    {
+        CGzipDataSink Sink(Compressed, CGzipDataSink::DefaultLevel);
+        GenerateDocument(Sink, Megabytes);
+    }
+    std::printf("document=%zuMB svgz=%zukB\n", Megabytes, Compressed->String().size() >> 10);
+    for(bool Prefetch : {false, true}){
+        auto Source = std::make_shared<CDecompressingDataSource>(std::make_shared<CStringDataSource>(Compressed->String()), CDecompressingDataSource::DefaultBlockSize, Prefetch);
+        RunParse(Prefetch ? "svgz prefetch" : "svgz", Source, Megabytes);
+    }
+    auto Raw = std::make_shared<CStringDataSink>();
+    GenerateDocument(*Raw, Megabytes);
+    RunParse("raw string", std::make_shared<CStringDataSource>(Raw->TakeString()), Megabytes);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "FileDataSink.h"
+#include "StringDataSink.h"
+#include "SVGWriter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+// Draws a scatter plot of the requested size into sink
+std::size_t Render(std::shared_ptr<CDataSink> sink, std::size_t shapes){
+    TAttributes Style{{"fill","blue"}};
+    CSVGWriter Writer(sink, 1000, 1000);
+    for(std::size_t Index = 0; Index < shapes; Index++){
+        SSVGPoint Center{(TSVGReal)(Index % 1000), (TSVGReal)((Index / 1000) % 1000) + 0.5};
+        Writer.Circle(Center, 2.5, Style);
+    }
+    return shapes;
+}
+
+void Report(const char *name, const std::string &path, std::chrono::steady_clock::time_point start, std::size_t writes){
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    off_t Bytes = 0;
+    int FileDescriptor = open(path.c_str(), O_RDONLY);
+    if(FileDescriptor >= 0){
+        Bytes = lseek(FileDescriptor, 0, SEEK_END);
+        close(FileDescriptor);
+    }
+    std::printf("%-24s bytes=%lld writes=%-7zu time=%.3fs MB/s=%.1f\n", name, (long long)Bytes, writes, Elapsed, Bytes / Elapsed / 1e6);
+    unlink(path.c_str());
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Shapes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    std::string Path = argc > 2 ? argv[2] : "filedatasinkbench.svg";
+
+    {
+        auto Start = std::chrono::steady_clock::now();
+        auto Sink = std::make_shared<CStringDataSink>();
+        Render(Sink, Shapes);
+        std::string Document = Sink->TakeString();
+        FILE *File = std::fopen(Path.c_str(), "wb");
+        std::fwrite(Document.data(), 1, Document.size(), File);
+        std::fclose(File);
+        Report("string sink + fwrite", Path, Start, 1);
+    }
+    const struct{
+        const char *DName;
+        std::size_t DBufferSize;
+        bool DVectored;
+        bool DDirect;
+    } Configurations[] = {
+        {"file sink 64K", 1 << 16, false, false},
+        {"file sink 1M", 1 << 20, false, false},
+        {"file sink 1M writev", 1 << 20, true, false},
+        {"file sink 1M O_DIRECT", 1 << 20, false, true}
+    };
+    for(auto &Configuration : Configurations){
+        auto Start = std::chrono::steady_clock::now();
+        std::size_t Writes;
+        {
+            auto Sink = std::make_shared<CFileDataSink>(Path, Configuration.DBufferSize, Configuration.DVectored, Configuration.DDirect);
+            Render(Sink, Shapes);
+            Sink->Close();
+            Writes = Sink->WriteCalls();
+        }
+        Report(Configuration.DName, Path, Start, Writes);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "GzipDataSink.h"
+#include "FileDataSink.h"
+#include "StringDataSink.h"
+#include "SVGWriter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <zlib.h>
+
+// Draws a scatter plot of the requested size into sink
+void Render(std::shared_ptr<CDataSink> sink, std::size_t shapes){
+    TAttributes Style{{"fill","blue"}};
+    CSVGWriter Writer(sink, 1000, 1000);
+    for(std::size_t Index = 0; Index < shapes; Index++){
+        SSVGPoint Center{(TSVGReal)(Index % 1000), (TSVGReal)((Index / 1000) % 1000) + 0.5};
+        Writer.Circle(Center, 2.5, Style);
+    }
+}
+
+// Gzips a whole document in one deflate call
+std::string Compress(const std::string &document, int level){
+    z_stream Stream{};
+    deflateInit2(&Stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+    std::string Result(deflateBound(&Stream, document.size()), '\0');
+    Stream.next_in = (Bytef *)document.data();
+    Stream.avail_in = (uInt)document.size();
+    Stream.next_out = (Bytef *)Result.data();
+    Stream.avail_out = (uInt)Result.size();
+    deflate(&Stream, Z_FINISH);
+    Result.resize(Stream.total_out);
+    deflateEnd(&Stream);
+    return Result;
+}
+
+void Report(const char *name, int level, std::chrono::steady_clock::time_point start, std::size_t bytes){
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-26s level=%d bytes=%-9zu time=%.3fs\n", name, level, bytes, Elapsed);
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Shapes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::string Path = argc > 2 ? argv[2] : "gzipdatasinkbench.svgz";
+
+    for(int Level : {1, 6}){
+        {
+            auto Start = std::chrono::steady_clock::now();
+            auto Sink = std::make_shared<CStringDataSink>();
+            Render(Sink, Shapes);
+            std::string Compressed = Compress(Sink->String(), Level);
+            Report("render then compress", Level, Start, Compressed.size());
+        }
+        for(bool Threaded : {false, true}){
+            auto Start = std::chrono::steady_clock::now();
+            auto Output = std::make_shared<CStringDataSink>();
+            {
+                auto Sink = std::make_shared<CGzipDataSink>(Output, Level, CGzipDataSink::DefaultBufferSize, Threaded);
+                Render(Sink, Shapes);
+                Sink->Close();
+            }
+            Report(Threaded ? "gzip sink threaded" : "gzip sink", Level, Start, Output->String().size());
+        }
+        {
+            auto Start = std::chrono::steady_clock::now();
+            std::size_t Bytes;
+            {
+                auto File = std::make_shared<CFileDataSink>(Path);
+                auto Sink = std::make_shared<CGzipDataSink>(File, Level, CGzipDataSink::DefaultBufferSize, true);
+                Render(Sink, Shapes);
+                Sink->Close();
+                File->Close();
+                Bytes = Sink->BytesOut();
+            }
+            Report("gzip sink threaded to file", Level, Start, Bytes);
+            std::remove(Path.c_str());
+        }
+    }
+    return 0;
+}
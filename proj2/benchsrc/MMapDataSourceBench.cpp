@@ -0,0 +1,81 @@
+#include "MMapDataSource.h"
+#include "StringDataSource.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Peak resident set size of this process in kB
+long PeakRSS(){
+    std::ifstream Status("/proc/self/status");
+    std::string Line;
+    while(std::getline(Status, Line)){
+        if(Line.compare(0, 6, "VmHWM:") == 0){
+            return std::strtol(Line.c_str() + 6, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+// Consumes the whole source so both variants touch every byte
+std::size_t Scan(CDataSource &source){
+    std::vector<char> Buffer;
+    std::size_t Sum = 0;
+    while(source.Read(Buffer, 65536)){
+        for(char Ch : Buffer){
+            Sum += Ch == '<';
+        }
+    }
+    return Sum;
+}
+
+// Runs each measurement in a child so peak RSS is not shared between them
+template <typename TFunction>
+void RunIsolated(const char *name, TFunction function){
+    std::fflush(stdout);
+    pid_t Child = fork();
+    if(Child == 0){
+        auto Start = std::chrono::steady_clock::now();
+        auto Source = function();
+        auto Ready = std::chrono::steady_clock::now();
+        std::size_t Tags = Scan(*Source);
+        auto Done = std::chrono::steady_clock::now();
+        std::printf("%-14s startup=%.3fs scan=%.3fs tags=%zu peakRSS=%ldMB\n", name,
+            std::chrono::duration<double>(Ready - Start).count(),
+            std::chrono::duration<double>(Done - Ready).count(), Tags, PeakRSS() / 1024);
+        std::exit(0);
+    }
+    waitpid(Child, nullptr, 0);
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    std::string Path = argc > 2 ? argv[2] : "mmapdatasourcebench.xml";
+    {
+        std::ofstream Output(Path, std::ios::binary);
+        std::string Line = "<circle cx=\"1\" cy=\"2\" r=\"3\" style=\"fill:red\"/>\n";
+        std::string Block;
+        while(Block.size() < (1 << 20)){
+            Block += Line;
+        }
+        for(std::size_t Index = 0; Index < Megabytes; Index++){
+            Output << Block;
+        }
+    }
+    RunIsolated("string source", [&](){
+        std::ifstream Input(Path, std::ios::binary);
+        std::stringstream Stream;
+        Stream << Input.rdbuf();
+        return std::make_unique<CStringDataSource>(Stream.str());
+    });
+    RunIsolated("mmap source", [&](){
+        return std::make_unique<CMMapDataSource>(Path);
+    });
+    unlink(Path.c_str());
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "svg.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Counts write callbacks and bytes without storing the output
+struct SBenchOutput{
+    std::size_t DCalls = 0;
+    std::size_t DBytes = 0;
+};
+
+svg_return_t count_callback(svg_user_context_ptr user, const char *text){
+    SBenchOutput *Output = static_cast<SBenchOutput *>(user);
+    while(*text){
+        Output->DBytes++;
+        text++;
+    }
+    Output->DCalls++;
+    return SVG_OK;
+}
+
+svg_return_t noop_cleanup(svg_user_context_ptr user){
+    return SVG_OK;
+}
+
+void RunCircles(std::size_t shapes, std::size_t buffersize){
+    SBenchOutput Output;
+    auto Start = std::chrono::steady_clock::now();
+    svg_context_ptr Context = svg_create_buffered(count_callback, noop_cleanup, &Output, 1000, 1000, buffersize);
+    for(std::size_t Index = 0; Index < shapes; Index++){
+        svg_point_t Center{(svg_real_t)(Index % 1000), (svg_real_t)((Index / 1000) % 1000)};
+        svg_circle(Context, &Center, 2.5, "fill:blue");
+    }
+    svg_destroy(Context);
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::printf("circles=%zu buffer=%-8zu callbacks=%-9zu callbacks/shape=%.5f time=%.3fs MB/s=%.1f\n",
+        shapes, buffersize, Output.DCalls, (double)Output.DCalls / shapes, Elapsed, Output.DBytes / Elapsed / 1e6);
+}
+
+void RunBatchCircles(std::size_t shapes, std::size_t buffersize){
+    SBenchOutput Output;
+    std::vector<svg_real_t> X(shapes), Y(shapes), R(shapes, 2.5);
+    for(std::size_t Index = 0; Index < shapes; Index++){
+        X[Index] = (svg_real_t)(Index % 1000);
+        Y[Index] = (svg_real_t)((Index / 1000) % 1000);
+    }
+    auto Start = std::chrono::steady_clock::now();
+    svg_context_ptr Context = svg_create_buffered(count_callback, noop_cleanup, &Output, 1000, 1000, buffersize);
+    svg_circles(Context, X.data(), Y.data(), R.data(), shapes, "fill:blue");
+    svg_destroy(Context);
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::printf("batch circles=%zu buffer=%-8zu callbacks=%-9zu callbacks/shape=%.5f time=%.3fs MB/s=%.1f\n",
+        shapes, buffersize, Output.DCalls, (double)Output.DCalls / shapes, Elapsed, Output.DBytes / Elapsed / 1e6);
+}
+
+// Circles sharing one style of the given length; the shape count shrinks
+// with the style so every run writes a similar number of bytes
+void RunStyleLength(std::size_t shapes, std::size_t stylelength){
+    SBenchOutput Output;
+    std::string Style = "fill:blue;" + std::string(stylelength, ' ');
+    Style.resize(stylelength);
+    shapes = shapes * 64 / (64 + stylelength) + 1;
+    auto Start = std::chrono::steady_clock::now();
+    svg_context_ptr Context = svg_create(count_callback, noop_cleanup, &Output, 1000, 1000);
+    std::size_t Failures = 0;
+    for(std::size_t Index = 0; Index < shapes; Index++){
+        svg_point_t Center{(svg_real_t)(Index % 1000), (svg_real_t)((Index / 1000) % 1000)};
+        Failures += svg_circle(Context, &Center, 2.5, Style.c_str()) != SVG_OK;
+    }
+    svg_destroy(Context);
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::printf("style=%-6zu circles=%-8zu failures=%-8zu ns/shape=%-8.1f MB/s=%.1f\n",
+        stylelength, shapes, Failures, Elapsed * 1e9 / shapes, Output.DBytes / Elapsed / 1e6);
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Shapes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t BufferSizes[] = {0, 4096, SVG_DEFAULT_BUFFER_SIZE, 1 << 20};
+
+    for(auto BufferSize : BufferSizes){
+        RunCircles(Shapes, BufferSize);
+    }
+    RunBatchCircles(Shapes, SVG_DEFAULT_BUFFER_SIZE);
+    for(std::size_t StyleLength : {0, 16, 64, 200, 1024, 4096, 65536}){
+        RunStyleLength(Shapes, StyleLength);
+    }
+    return 0;
+}
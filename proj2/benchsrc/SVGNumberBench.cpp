@@ -0,0 +1,46 @@
+#include "svg_number.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Compares svg_format_real against the snprintf("%f") path it replaced
+template <typename TFormatter>
+void RunFormat(const char *name, const std::vector<svg_real_t> &values, TFormatter formatter){
+    char Buffer[SVG_NUMBER_BUFFER_SIZE];
+    std::size_t Bytes = 0;
+    auto Start = std::chrono::steady_clock::now();
+    for(auto Value : values){
+        Bytes += formatter(Buffer, Value);
+    }
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::printf("%-22s values=%zu time=%.3fs ns/value=%.1f bytes/value=%.2f\n",
+        name, values.size(), Elapsed, Elapsed * 1e9 / values.size(), (double)Bytes / values.size());
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    std::vector<svg_real_t> Integers, Fractions;
+
+    std::srand(36);
+    for(std::size_t Index = 0; Index < Count; Index++){
+        Integers.push_back(std::rand() % 2000);
+        Fractions.push_back((std::rand() % 200000) / 100.0);
+    }
+    for(auto Values : {&Integers, &Fractions}){
+        std::printf("%s coordinates\n", Values == &Integers ? "integer" : "two-decimal");
+        RunFormat("snprintf %f", *Values, [](char *buffer, svg_real_t value){
+            return (std::size_t)std::snprintf(buffer, SVG_NUMBER_BUFFER_SIZE, "%f", value);
+        });
+        RunFormat("snprintf %.17g", *Values, [](char *buffer, svg_real_t value){
+            return (std::size_t)std::snprintf(buffer, SVG_NUMBER_BUFFER_SIZE, "%.17g", value);
+        });
+        RunFormat("svg_format_real short", *Values, [](char *buffer, svg_real_t value){
+            return svg_format_real(buffer, value, SVG_PRECISION_SHORTEST);
+        });
+        RunFormat("svg_format_real 2dp", *Values, [](char *buffer, svg_real_t value){
+            return svg_format_real(buffer, value, 2);
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "SVGReader.h"
+#include "StringDataSource.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+int main(int argc, char *argv[]){
+    std::string Document = "<svg width=\"1000\" height=\"1000\">";
+    for(int Index = 0; Index < 200000; Index++){
+        std::string X = std::to_string(Index % 1000) + ".25";
+        std::string Y = std::to_string(Index / 1000) + ".75";
+        switch(Index % 3){
+            case 0: Document += "<circle cx=\"" + X + "\" cy=\"" + Y + "\" r=\"2\" style=\"fill:red\"/>";
+                    break;
+            case 1: Document += "<rect x=\"" + X + "\" y=\"" + Y + "\" width=\"4\" height=\"3\" style=\"fill:blue\"/>";
+                    break;
+            default:Document += "<line x1=\"" + X + "\" y1=\"" + Y + "\" x2=\"" + Y + "\" y2=\"" + X + "\" style=\"stroke:black\"/>";
+                    break;
+        }
+    }
+    Document += "</svg>";
+
+    // Entity read with attribute lookups by name and std::stod per value
+    double Total = 0;
+    auto Start = std::chrono::steady_clock::now();
+    {
+        CXMLReader Reader(std::make_shared<CStringDataSource>(Document));
+        SXMLEntity Entity;
+        while(Reader.ReadEntity(Entity, true)){
+            if(Entity.DType != SXMLEntity::EType::StartElement || Entity.DNameData == "svg"){
+                continue;
+            }
+            double Sum = 0;
+            for(const char *Name : {"cx", "cy", "r", "x", "y", "width", "height", "x1", "y1", "x2", "y2"}){
+                if(Entity.AttributeExists(Name)){
+                    Sum += std::stod(Entity.AttributeValue(Name));
+                }
+            }
+            Total += Sum;
+        }
+    }
+    double EntityTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    double ShapeTotal = 0;
+    Start = std::chrono::steady_clock::now();
+    {
+        CSVGReader Reader(std::make_shared<CStringDataSource>(Document));
+        SSVGShape Shape;
+        while(Reader.ReadShape(Shape)){
+            switch(Shape.DType){
+                case SSVGShape::EType::Circle:      ShapeTotal += Shape.DPoint.DX + Shape.DPoint.DY + Shape.DRadius;
+                                                    break;
+                case SSVGShape::EType::Rectangle:   ShapeTotal += Shape.DPoint.DX + Shape.DPoint.DY + Shape.DSize.DWidth + Shape.DSize.DHeight;
+                                                    break;
+                case SSVGShape::EType::Line:        ShapeTotal += Shape.DPoint.DX + Shape.DPoint.DY + Shape.DEnd.DX + Shape.DEnd.DY;
+                                                    break;
+                default:                            break;
+            }
+        }
+    }
+    double ShapeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    std::printf("shapes: entity+stod=%.1fms shape=%.1fms speedup=%.2fx (%s)\n",
+        EntityTime * 1e3, ShapeTime * 1e3, EntityTime / ShapeTime, Total == ShapeTotal ? "match" : "MISMATCH");
+    return 0;
+}
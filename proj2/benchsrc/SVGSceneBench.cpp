@@ -0,0 +1,98 @@
+#include "SVGScene.h"
+#include "StringDataSource.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <string>
+
+// Tracks the heap bytes currently allocated through operator new
+static std::size_t LiveBytes = 0;
+
+void *operator new(std::size_t size){
+    if(void *Pointer = std::malloc(size ? size : 1)){
+        LiveBytes += malloc_usable_size(Pointer);
+        return Pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept{
+    if(pointer){
+        LiveBytes -= malloc_usable_size(pointer);
+    }
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept{
+    operator delete(pointer);
+}
+
+int main(int argc, char *argv[]){
+    const int Shapes = 300000;
+    std::string Document = "<svg width=\"1000\" height=\"1000\">";
+    for(int Index = 0; Index < Shapes; Index++){
+        if(Index % 1000 == 0){
+            Document += Index ? "</g><g>" : "<g>";
+        }
+        std::string X = std::to_string(Index % 1000) + ".25";
+        std::string Y = std::to_string(Index / 1000) + ".75";
+        std::string Style = "\" style=\"fill:color" + std::to_string(Index % 16) + "\"/>";
+        switch(Index % 3){
+            case 0: Document += "<circle cx=\"" + X + "\" cy=\"" + Y + "\" r=\"2" + Style;
+                    break;
+            case 1: Document += "<rect x=\"" + X + "\" y=\"" + Y + "\" width=\"4\" height=\"3" + Style;
+                    break;
+            default:Document += "<line x1=\"" + X + "\" y1=\"" + Y + "\" x2=\"" + Y + "\" y2=\"" + X + Style;
+                    break;
+        }
+    }
+    Document += "</g></svg>";
+
+    std::size_t Before = LiveBytes;
+    auto Start = std::chrono::steady_clock::now();
+    std::vector<SXMLEntity> Entities;
+    {
+        CXMLReader Reader(std::make_shared<CStringDataSource>(Document));
+        SXMLEntity Entity;
+        while(Reader.ReadEntity(Entity, true)){
+            Entities.push_back(Entity);
+        }
+    }
+    double EntityTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::size_t EntityBytes = LiveBytes - Before;
+
+    // Bounding box pass over the entity vector
+    Start = std::chrono::steady_clock::now();
+    double EntityMaxX = 0;
+    for(auto &Entity : Entities){
+        if(Entity.DType == SXMLEntity::EType::StartElement && Entity.DNameData == "circle"){
+            EntityMaxX = std::max(EntityMaxX, std::stod(Entity.AttributeValue("cx")) + std::stod(Entity.AttributeValue("r")));
+        }
+    }
+    double EntityPassTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    Entities = std::vector<SXMLEntity>();
+
+    Before = LiveBytes;
+    Start = std::chrono::steady_clock::now();
+    SSVGScene Scene;
+    CSVGSceneLoader Loader;
+    Loader.Load(std::make_shared<CStringDataSource>(Document), Scene);
+    double SceneTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::size_t SceneBytes = LiveBytes - Before;
+
+    Start = std::chrono::steady_clock::now();
+    double SceneMaxX = 0;
+    for(std::size_t Index = 0; Index < Scene.DCircles.Size(); Index++){
+        SceneMaxX = std::max(SceneMaxX, Scene.DCircles.DX[Index] + Scene.DCircles.DRadius[Index]);
+    }
+    double ScenePassTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    std::printf("load: entities=%.1fms scene=%.1fms speedup=%.2fx\n", EntityTime * 1e3, SceneTime * 1e3, EntityTime / SceneTime);
+    std::printf("memory per shape: entities=%.1fB scene=%.1fB (MemoryUsage %.1fB)\n",
+        double(EntityBytes) / Shapes, double(SceneBytes) / Shapes, double(Scene.MemoryUsage()) / Shapes);
+    std::printf("circle bounds pass: entities=%.2fms scene=%.2fms (%s)\n", EntityPassTime * 1e3, ScenePassTime * 1e3, EntityMaxX == SceneMaxX ? "match" : "MISMATCH");
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "SVGSceneWriter.h"
+#include "SVGWriter.h"
+#include "StringDataSink.h"
+#include "StringDataSource.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+int main(int argc, char *argv[]){
+    const int Shapes = 300000;
+    std::string Document = "<svg width=\"1000\" height=\"1000\">";
+    for(int Index = 0; Index < Shapes; Index++){
+        std::string X = std::to_string(Index % 1000) + ".25";
+        std::string Y = std::to_string(Index / 1000) + ".75";
+        std::string Style = "\" style=\"fill:color" + std::to_string(Index / 50 % 16) + ";stroke:black;stroke-width:1\"/>";
+        switch(Index / 10 % 3){
+            case 0: Document += "<circle cx=\"" + X + "\" cy=\"" + Y + "\" r=\"2" + Style;
+                    break;
+            case 1: Document += "<rect x=\"" + X + "\" y=\"" + Y + "\" width=\"4\" height=\"3" + Style;
+                    break;
+            default:Document += "<line x1=\"" + X + "\" y1=\"" + Y + "\" x2=\"" + Y + "\" y2=\"" + X + Style;
+                    break;
+        }
+    }
+    Document += "</svg>";
+
+    SSVGScene Scene;
+    CSVGSceneLoader().Load(std::make_shared<CStringDataSource>(Document), Scene);
+    std::vector<TAttributes> Styles;
+    for(auto &Style : Scene.DStyles){
+        TAttributes Attributes;
+        std::size_t Begin = 0;
+        while(Begin < Style.size()){
+            std::size_t End = std::min(Style.find(';', Begin), Style.size());
+            std::size_t Colon = Style.find(':', Begin);
+            Attributes.emplace_back(Style.substr(Begin, Colon - Begin), Style.substr(Colon + 1, End - Colon - 1));
+            Begin = End + 1;
+        }
+        Styles.push_back(Attributes);
+    }
+
+    // Replaying one shape at a time, building each style from its attributes
+    auto Start = std::chrono::steady_clock::now();
+    std::size_t ShapeBytes;
+    {
+        auto Sink = std::make_shared<CStringDataSink>();
+        {
+            CSVGWriter Writer(Sink, 1000, 1000);
+            for(auto &Run : Scene.DRuns){
+                for(std::size_t Index = Run.DBegin; Index < Run.DBegin + Run.DCount; Index++){
+                    switch(Run.DType){
+                        case SSVGShape::EType::Circle:      Writer.Circle({Scene.DCircles.DX[Index], Scene.DCircles.DY[Index]}, Scene.DCircles.DRadius[Index], Styles[Scene.DCircles.DStyle[Index]]);
+                                                            break;
+                        case SSVGShape::EType::Rectangle:   Writer.Rectange({Scene.DRectangles.DX[Index], Scene.DRectangles.DY[Index]}, {Scene.DRectangles.DWidth[Index], Scene.DRectangles.DHeight[Index]}, Styles[Scene.DRectangles.DStyle[Index]]);
+                                                            break;
+                        case SSVGShape::EType::Line:        Writer.Line({Scene.DLines.DX1[Index], Scene.DLines.DY1[Index]}, {Scene.DLines.DX2[Index], Scene.DLines.DY2[Index]}, Styles[Scene.DLines.DStyle[Index]]);
+                                                            break;
+                        default:                            break;
+                    }
+                }
+            }
+        }
+        ShapeBytes = Sink->String().size();
+    }
+    double ShapeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    Start = std::chrono::steady_clock::now();
+    std::size_t BatchBytes;
+    {
+        auto Sink = std::make_shared<CStringDataSink>();
+        CSVGSceneWriter(Sink).Write(Scene);
+        BatchBytes = Sink->String().size();
+    }
+    double BatchTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    // Reading the whole document before writing it, against the pipeline
+    Start = std::chrono::steady_clock::now();
+    {
+        SSVGScene Loaded;
+        CSVGSceneLoader().Load(std::make_shared<CStringDataSource>(Document), Loaded);
+        CSVGSceneWriter(std::make_shared<CStringDataSink>()).Write(Loaded);
+    }
+    double SerialTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    Start = std::chrono::steady_clock::now();
+    std::size_t PipeBytes;
+    {
+        auto Sink = std::make_shared<CStringDataSink>();
+        CSVGSceneWriter(Sink).Pipe(std::make_shared<CStringDataSource>(Document));
+        PipeBytes = Sink->String().size();
+    }
+    double PipeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    std::printf("write %zu runs: per shape=%.1fms batched=%.1fms speedup=%.2fx (%s)\n", Scene.DRuns.size(),
+        ShapeTime * 1e3, BatchTime * 1e3, ShapeTime / BatchTime, ShapeBytes == BatchBytes ? "match" : "MISMATCH");
+    std::printf("read+write: load then write=%.1fms pipelined=%.1fms speedup=%.2fx (%s)\n",
+        SerialTime * 1e3, PipeTime * 1e3, SerialTime / PipeTime, PipeBytes == BatchBytes ? "match" : "MISMATCH");
+    return 0;
+}
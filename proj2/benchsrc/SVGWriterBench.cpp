@@ -0,0 +1,130 @@
+#include "SVGWriter.h"
+#include "StringDataSink.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Sink that only accepts single characters, so every byte goes through the
+// default CDataSink::Write and one virtual Put call (the pre-span behaviour)
+class CPutOnlySink : public CDataSink{
+    public:
+        std::string DString;
+
+        bool Put(const char &ch) noexcept override{
+            DString += ch;
+            return true;
+        }
+
+        bool Write(const std::vector<char> &buf) noexcept override{
+            DString.append(buf.data(), buf.size());
+            return true;
+        }
+};
+
+template <typename TSink>
+void RunDrawing(const char *name, std::size_t shapes){
+    std::shared_ptr<TSink> Sink = std::make_shared<TSink>();
+    TAttributes Style{{"fill","blue"},{"stroke","black"}};
+    auto Start = std::chrono::steady_clock::now();
+    {
+        CSVGWriter Writer(Sink, 1000, 1000);
+        for(std::size_t Index = 0; Index < shapes; Index++){
+            SSVGPoint Center{(TSVGReal)(Index % 1000), (TSVGReal)((Index / 1000) % 1000)};
+            Writer.Circle(Center, 2.5, Style);
+        }
+    }
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::size_t Bytes = Sink->DString.size();
+    std::printf("%-14s shapes=%zu bytes=%zu time=%.3fs MB/s=%.1f\n", name, shapes, Bytes, Elapsed, Bytes / Elapsed / 1e6);
+}
+
+// Exposes the sink string under the same member name as CPutOnlySink
+class CBenchStringSink : public CStringDataSink{
+    public:
+        const std::string &DString = String();
+};
+
+// Circles cycling through a handful of chart styles, serialised per call
+// (cachesize 0), through the style cache, or through registered handles
+void RunStyles(const char *name, std::size_t shapes, std::size_t cachesize, bool handles){
+    std::shared_ptr<CBenchStringSink> Sink = std::make_shared<CBenchStringSink>();
+    std::vector<TAttributes> Styles;
+    for(int Index = 0; Index < 8; Index++){
+        Styles.push_back({{"fill","series-color-" + std::to_string(Index)},{"stroke","black"},{"stroke-width","0.5"}});
+    }
+    auto Start = std::chrono::steady_clock::now();
+    CSVGWriter::SStyleCacheStats Stats;
+    {
+        CSVGWriter Writer(Sink, 1000, 1000, cachesize);
+        std::vector<SSVGStyleHandle> Handles;
+        for(auto &Style : Styles){
+            Handles.push_back(Writer.RegisterStyle(Style));
+        }
+        for(std::size_t Index = 0; Index < shapes; Index++){
+            SSVGPoint Center{(TSVGReal)(Index % 1000), (TSVGReal)((Index / 1000) % 1000)};
+            if(handles){
+                Writer.Circle(Center, 2.5, Handles[Index % Handles.size()]);
+            }
+            else{
+                Writer.Circle(Center, 2.5, Styles[Index % Styles.size()]);
+            }
+        }
+        Stats = Writer.StyleCacheStats();
+    }
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::printf("%-14s shapes=%zu time=%.3fs ns/shape=%.1f hits=%zu misses=%zu\n", name, shapes, Elapsed, Elapsed * 1e9 / shapes, Stats.DHits, Stats.DMisses);
+}
+
+// A noisy sine time series drawn with SimplePath segments or one path,
+// optionally decimated to the 1000 pixel wide canvas
+void RunTimeSeries(const char *name, const std::vector<SSVGPoint> &points, const SSVGPathOptions *options, CSVGWriter::EDecimation decimation = CSVGWriter::EDecimation::None){
+    std::shared_ptr<CBenchStringSink> Sink = std::make_shared<CBenchStringSink>();
+    TAttributes Style{{"fill","none"},{"stroke","black"}};
+    auto Start = std::chrono::steady_clock::now();
+    {
+        CSVGWriter Writer(Sink, 1000, 1000);
+        Writer.SetDecimation(decimation);
+        if(options){
+            Writer.Path(points.data(), points.size(), *options, Style);
+        }
+        else{
+            Writer.SimplePath(points, Style);
+        }
+    }
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::printf("%-22s points=%zu bytes=%zu bytes/point=%.1f time=%.3fs\n", name, points.size(), Sink->DString.size(), double(Sink->DString.size()) / points.size(), Elapsed);
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Shapes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    RunDrawing<CPutOnlySink>("per-char Put", Shapes);
+    RunDrawing<CBenchStringSink>("span Write", Shapes);
+    RunStyles("uncached style", Shapes, 0, false);
+    RunStyles("cached style", Shapes, CSVGWriter::DefaultStyleCacheSize, false);
+    RunStyles("style handle", Shapes, CSVGWriter::DefaultStyleCacheSize, true);
+
+    std::vector<SSVGPoint> Series;
+    std::uint32_t Noise = 1;
+    for(std::size_t Index = 0; Index < Shapes; Index++){
+        Noise = Noise * 1664525 + 1013904223;
+        Series.push_back({Index * 1000.0 / Shapes, 500 + 300 * std::sin(Index * 0.0001) + (Noise >> 24) / 64.0});
+    }
+    SSVGPathOptions Absolute, Relative, Simplified;
+    Relative.DRelative = Simplified.DRelative = true;
+    Relative.DPrecision = Simplified.DPrecision = 2;
+    Simplified.DTolerance = 0.5;
+    RunTimeSeries("SimplePath lines", Series, nullptr);
+    RunTimeSeries("path absolute", Series, &Absolute);
+    RunTimeSeries("path relative 2dp", Series, &Relative);
+    RunTimeSeries("path relative 2dp 0.5", Series, &Simplified);
+    RunTimeSeries("SimplePath minmax", Series, nullptr, CSVGWriter::EDecimation::MinMax);
+    RunTimeSeries("path minmax", Series, &Absolute, CSVGWriter::EDecimation::MinMax);
+    RunTimeSeries("path relative minmax", Series, &Relative, CSVGWriter::EDecimation::MinMax);
+    RunTimeSeries("path relative lttb", Series, &Relative, CSVGWriter::EDecimation::LTTB);
+    return 0;
+}
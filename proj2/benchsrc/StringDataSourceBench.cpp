@@ -0,0 +1,65 @@
+#include "StringDataSource.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Forwards only Get, so reads go through the per-character default
+class CGetOnlySource : public CDataSource{
+    private:
+        CStringDataSource DSource;
+    public:
+        CGetOnlySource(const std::string &str) : DSource(str){}
+
+        bool End() const noexcept override{
+            return DSource.End();
+        }
+        bool Get(char &ch) noexcept override{
+            return DSource.Get(ch);
+        }
+        bool Peek(char &ch) noexcept override{
+            return DSource.Peek(ch);
+        }
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override{
+            return false;
+        }
+};
+
+std::size_t ReadBulk(CDataSource &source, std::size_t chunksize){
+    std::vector<char> Buffer(chunksize);
+    std::size_t Total = 0, Count;
+    while((Count = source.Read(Buffer.data(), chunksize))){
+        Total += Count;
+    }
+    return Total;
+}
+
+std::size_t ReadVector(CDataSource &source, std::size_t chunksize){
+    std::vector<char> Buffer;
+    std::size_t Total = 0;
+    while(source.Read(Buffer, chunksize)){
+        Total += Buffer.size();
+    }
+    return Total;
+}
+
+template <typename TSource>
+void RunChunks(const char *name, std::size_t chunksize, const std::string &data, std::size_t (*read)(CDataSource &, std::size_t)){
+    TSource Source(data);
+    auto Start = std::chrono::steady_clock::now();
+    std::size_t Total = read(Source, chunksize);
+    auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::printf("%-18s chunk=%-7zu bytes=%zu time=%.3fs MB/s=%.1f\n", name, chunksize, Total, Elapsed, Total / Elapsed / 1e6);
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    std::string Data(Megabytes << 20, 'x');
+
+    for(std::size_t ChunkSize : {64, 512, 4096, 65536}){
+        RunChunks<CGetOnlySource>("per-char Get", ChunkSize, Data, ReadBulk);
+        RunChunks<CStringDataSource>("vector Read", ChunkSize, Data, ReadVector);
+        RunChunks<CStringDataSource>("bulk Read", ChunkSize, Data, ReadBulk);
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "XMLBatchReader.h"
+#include "StringDataSource.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+// An SVG document of roughly 64 KB
+std::string GenerateDocument(std::size_t index){
+    std::string Document = "<svg width=\"1000\" height=\"1000\">";
+    for(std::size_t Element = 0; Document.size() < 65536; Element++){
+        Document += "<circle cx=\"" + std::to_string(Element % 1000) + "\" cy=\"" + std::to_string(index % 777) + "\" r=\"2.5\" style=\"fill:blue\"/>\n";
+    }
+    return Document + "</svg>";
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Documents = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    std::size_t MaxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector< std::string > Texts;
+    std::size_t Bytes = 0;
+    for(std::size_t Index = 0; Index < Documents; Index++){
+        Texts.push_back(GenerateDocument(Index));
+        Bytes += Texts.back().size();
+    }
+
+    double BaseTime = 0;
+    for(std::size_t Threads = 1; Threads <= std::max<std::size_t>(MaxThreads, 4); Threads *= 2){
+        std::vector< std::shared_ptr< CDataSource > > Sources;
+        for(auto &Text : Texts){
+            Sources.push_back(std::make_shared<CStringDataSource>(Text));
+        }
+        CXMLBatchReader Reader(Threads);
+        std::atomic<std::size_t> Entities(0);
+        auto Start = std::chrono::steady_clock::now();
+        Reader.Ingest(Sources, [&Entities](std::size_t, const SXMLEntityView &){
+            Entities.fetch_add(1, std::memory_order_relaxed);
+        }, true);
+        auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+        if(Threads == 1){
+            BaseTime = Elapsed;
+        }
+        std::printf("threads=%-3zu docs=%zu entities=%zu time=%.3fs docs/s=%.0f MB/s=%.1f speedup=%.2fx (hardware threads %zu)\n",
+            Threads, Documents, Entities.load(), Elapsed, Documents / Elapsed, Bytes / Elapsed / 1e6, BaseTime / Elapsed, MaxThreads);
+    }
+    return 0;
+}
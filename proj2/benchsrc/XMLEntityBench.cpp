@@ -0,0 +1,51 @@
+#include "XMLEntity.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Attribute lookups as done before CXMLAttributes: a linear scan that
+// returns the value by copy
+std::string LinearAttributeValue(const TAttributes &attrs, const std::string &name){
+    for(auto &Attribute : attrs){
+        if(std::get<0>(Attribute) == name){
+            return std::get<1>(Attribute);
+        }
+    }
+    return std::string();
+}
+
+int main(int argc, char *argv[]){
+    const std::size_t Lookups = 20000000;
+
+    for(std::size_t Count : {2, 8, 64}){
+        TAttributes Linear;
+        SXMLEntity Entity;
+        std::vector<std::string> Names;
+        for(std::size_t Index = 0; Index < Count; Index++){
+            // Long enough values that a copy has to allocate
+            std::string Name = "attribute-" + std::to_string(Index);
+            std::string Value = "value-" + std::to_string(Index) + "-0123456789abcdef";
+            Linear.emplace_back(Name, Value);
+            Entity.SetAttribute(Name, Value);
+            Names.push_back(Name);
+        }
+        Names.push_back("missing");
+
+        std::size_t Total = 0;
+        auto Start = std::chrono::steady_clock::now();
+        for(std::size_t Index = 0; Index < Lookups; Index++){
+            Total += LinearAttributeValue(Linear, Names[Index % Names.size()]).size();
+        }
+        double LinearTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+        Start = std::chrono::steady_clock::now();
+        for(std::size_t Index = 0; Index < Lookups; Index++){
+            Total += Entity.AttributeValue(Names[Index % Names.size()]).size();
+        }
+        double IndexedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+        std::printf("attributes=%-3zu linear=%.1fns/lookup indexed=%.1fns/lookup speedup=%.2fx (%zu)\n",
+            Count, LinearTime * 1e9 / Lookups, IndexedTime * 1e9 / Lookups, LinearTime / IndexedTime, Total);
+    }
+    return 0;
+}
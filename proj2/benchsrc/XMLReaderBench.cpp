@@ -0,0 +1,136 @@
+#include "XMLReader.h"
+#include "XMLNameTable.h"
+#include "MMapDataSource.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+// Counts every heap allocation made by the process
+static std::size_t AllocationCount = 0;
+
+void *operator new(std::size_t size){
+    AllocationCount++;
+    if(void *Pointer = std::malloc(size ? size : 1)){
+        return Pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept{
+    std::free(pointer);
+}
+
+// Peak resident set size of this process in kB
+long PeakRSS(){
+    std::ifstream Status("/proc/self/status");
+    std::string Line;
+    while(std::getline(Status, Line)){
+        if(Line.compare(0, 6, "VmHWM:") == 0){
+            return std::strtol(Line.c_str() + 6, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+// Writes an SVG shaped document of roughly megabytes MB to path
+void GenerateDocument(const std::string &path, std::size_t megabytes){
+    std::ofstream Output(path, std::ios::binary);
+    std::string Block;
+    for(int Index = 0; Block.size() < (1 << 20); Index++){
+        Block += "<circle cx=\"" + std::to_string(Index % 1000) + "\" cy=\"" + std::to_string(Index % 777) + ".5\" r=\"2.5\" style=\"fill:blue\"/>\n";
+    }
+    Output << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg width=\"1000\" height=\"1000\" xmlns=\"http://www.w3.org/2000/svg\">\n<g>\n";
+    for(std::size_t Index = 0; Index < megabytes; Index++){
+        Output << Block;
+    }
+    Output << "</g>\n</svg>\n";
+}
+
+int main(int argc, char *argv[]){
+    std::size_t Megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+    std::string Path = argc > 2 ? argv[2] : "xmlreaderbench.svg";
+
+    GenerateDocument(Path, Megabytes);
+    for(std::size_t ChunkSize : {4096, 65536, 1 << 20}){
+        for(bool SkipCData : {false, true}){
+            for(bool Views : {false, true}){
+                auto Source = std::make_shared<CMMapDataSource>(Path);
+                CXMLReader Reader(Source, ChunkSize);
+                SXMLEntityView EntityView;
+                std::size_t Entities = 0;
+                std::size_t Allocations = AllocationCount;
+                auto Start = std::chrono::steady_clock::now();
+                if(Views){
+                    while(Reader.ReadEntityView(EntityView, SkipCData)){
+                        Entities++;
+                    }
+                }
+                else{
+                    // A fresh entity per read, as typical callers declare it
+                    while(true){
+                        SXMLEntity Entity;
+                        if(!Reader.ReadEntity(Entity, SkipCData)){
+                            break;
+                        }
+                        Entities++;
+                    }
+                }
+                auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+                Allocations = AllocationCount - Allocations;
+                CXMLNameTable::SStats Names = Reader.NameTable().Stats();
+                std::printf("%-5s chunk=%-8zu skipcdata=%d MB=%zu entities=%zu time=%.3fs entities/s=%.0f MB/s=%.1f allocs/entity=%.4f names=%zu namehits=%.4f peakRSS=%ldMB\n",
+                    Views ? "view" : "owned", ChunkSize, SkipCData, Megabytes, Entities, Elapsed, Entities / Elapsed, Source->Size() / Elapsed / 1e6, double(Allocations) / Entities, Names.DSize, Names.HitRate(), PeakRSS() / 1024);
+            }
+        }
+    }
+    // Hand written tokenizer against expat, both through the view API
+    double ExpatTime = 0;
+    for(bool FastTokenizer : {false, true}){
+        auto Source = std::make_shared<CMMapDataSource>(Path);
+        CXMLReader Reader(Source, CXMLReader::DefaultChunkSize, 0, 1, FastTokenizer);
+        SXMLEntityView EntityView;
+        std::size_t Entities = 0;
+        auto Start = std::chrono::steady_clock::now();
+        while(Reader.ReadEntityView(EntityView)){
+            Entities++;
+        }
+        auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+        if(!FastTokenizer){
+            ExpatTime = Elapsed;
+        }
+        std::printf("%-9s MB=%zu entities=%zu time=%.3fs entities/s=%.0f MB/s=%.1f speedup=%.2fx\n",
+            FastTokenizer ? "fast" : "expat", Megabytes, Entities, Elapsed, Entities / Elapsed, Source->Size() / Elapsed / 1e6, ExpatTime / Elapsed);
+    }
+
+    // Single document split between threads, against one thread
+    double BaseTime = 0;
+    std::size_t MaxThreads = std::max(4u, std::thread::hardware_concurrency());
+    for(std::size_t Threads = 1; Threads <= MaxThreads; Threads *= 2){
+        auto Source = std::make_shared<CMMapDataSource>(Path);
+        CXMLReader Reader(Source, CXMLReader::DefaultChunkSize, 0, Threads);
+        SXMLEntityView EntityView;
+        std::size_t Entities = 0;
+        auto Start = std::chrono::steady_clock::now();
+        while(Reader.ReadEntityView(EntityView, true)){
+            Entities++;
+        }
+        auto Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+        if(Threads == 1){
+            BaseTime = Elapsed;
+        }
+        std::printf("threads=%-3zu MB=%zu entities=%zu time=%.3fs MB/s=%.1f speedup=%.2fx peakRSS=%ldMB\n",
+            Threads, Megabytes, Entities, Elapsed, Source->Size() / Elapsed / 1e6, BaseTime / Elapsed, PeakRSS() / 1024);
+    }
+    unlink(Path.c_str());
+    return 0;
+}
@@ -1,6 +1,7 @@
 #ifndef DATASINK_H
 #define DATASINK_H
 
+#include <cstddef>
 #include <vector>
 
 class CDataSink{
@@ -8,6 +9,17 @@ class CDataSink{
         virtual ~CDataSink(){};
         virtual bool Put(const char &ch) noexcept = 0;
         virtual bool Write(const std::vector<char> &buf) noexcept = 0;
+
+        // Writes length bytes starting at buf; sinks should override this
+        // to accept the whole span at once instead of one Put per byte.
+        virtual bool Write(const char *buf, std::size_t length) noexcept{
+            for(std::size_t Index = 0; Index < length; Index++){
+                if(!Put(buf[Index])){
+                    return false;
+                }
+            }
+            return true;
+        };
 };
 
 #endif
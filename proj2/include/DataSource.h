@@ -1,6 +1,8 @@
 #ifndef DATASOURCE_H
 #define DATASOURCE_H
 
+#include <cstddef>
+#include <string_view>
 #include <vector>
 
 class CDataSource{
@@ -10,6 +12,23 @@ class CDataSource{
         virtual bool Get(char &ch) noexcept = 0;
         virtual bool Peek(char &ch) noexcept = 0;
         virtual bool Read(std::vector<char> &buf, std::size_t count) noexcept = 0;
+
+        // Copies up to capacity bytes into the caller owned buf and returns
+        // the number copied; sources should override this with a bulk copy.
+        virtual std::size_t Read(char *buf, std::size_t capacity) noexcept{
+            std::size_t Count = 0;
+            while(Count < capacity && Get(buf[Count])){
+                Count++;
+            }
+            return Count;
+        };
+
+        // Unread input when the source already holds all of it in memory,
+        // valid until the source is read from or destroyed; streaming
+        // sources return an empty view.
+        virtual std::string_view Contents() const noexcept{
+            return std::string_view();
+        };
 };
 
 #endif
@@ -0,0 +1,36 @@
+#ifndef DECOMPRESSINGDATASOURCE_H
+#define DECOMPRESSINGDATASOURCE_H
+
+#include "DataSource.h"
+#include <memory>
+
+// Decompresses another source block by block, detecting the format from
+// its magic bytes; input in neither format is passed through unchanged.
+// zstd needs a build with SVG_HAVE_ZSTD defined and -lzstd, otherwise
+// zstd input is detected but leaves the source invalid.
+class CDecompressingDataSource : public CDataSource{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+    public:
+        enum class EFormat{Raw, Gzip, Zstd};
+
+        static constexpr std::size_t DefaultBlockSize = 1 << 16;
+
+        // prefetch decompresses the next blocks on a helper thread while
+        // the current one is consumed
+        CDecompressingDataSource(std::shared_ptr< CDataSource > src, std::size_t blocksize = DefaultBlockSize, bool prefetch = false);
+        ~CDecompressingDataSource();
+
+        // False once the input turns out corrupt, truncated or unsupported
+        bool Valid() const noexcept;
+        EFormat Format() const noexcept;
+
+        bool End() const noexcept override;
+        bool Get(char &ch) noexcept override;
+        bool Peek(char &ch) noexcept override;
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+        std::size_t Read(char *buf, std::size_t capacity) noexcept override;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef FILEDATASINK_H
+#define FILEDATASINK_H
+
+#include "DataSink.h"
+#include <memory>
+#include <string>
+
+class CFileDataSink : public CDataSink{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+    public:
+        static constexpr std::size_t DefaultBufferSize = 1 << 20;
+
+        // Writes to an already open descriptor, closing it on Close() only if ownsfd
+        CFileDataSink(int fd, bool ownsfd = false, std::size_t buffersize = DefaultBufferSize, bool vectored = true);
+        // Creates or truncates path; direct requests O_DIRECT with block aligned writes
+        CFileDataSink(const std::string &path, std::size_t buffersize = DefaultBufferSize, bool vectored = true, bool direct = false);
+        ~CFileDataSink();
+
+        bool Valid() const noexcept;
+        bool Direct() const noexcept;
+        std::size_t WriteCalls() const noexcept;
+        bool Flush() noexcept;
+        bool Close() noexcept;
+
+        bool Put(const char &ch) noexcept override;
+        bool Write(const std::vector<char> &buf) noexcept override;
+        bool Write(const char *buf, std::size_t length) noexcept override;
+};
+
+#endif
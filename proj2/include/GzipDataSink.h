@@ -0,0 +1,39 @@
+#ifndef GZIPDATASINK_H
+#define GZIPDATASINK_H
+
+#include "DataSink.h"
+#include <memory>
+
+// Compresses everything written into gzip format (e.g. .svgz) on the fly
+// and passes the compressed bytes on to another sink
+class CGzipDataSink : public CDataSink{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+    public:
+        static constexpr int DefaultLevel = 6;
+        static constexpr std::size_t DefaultBufferSize = 1 << 16;
+
+        // level is a zlib level from 0 (store) to 9 (best); threaded moves
+        // deflate to a dedicated thread fed with buffersize blocks so that
+        // formatting and compression overlap
+        CGzipDataSink(std::shared_ptr< CDataSink > sink, int level = DefaultLevel, std::size_t buffersize = DefaultBufferSize, bool threaded = false);
+        // Closes the stream, writing the gzip trailer
+        ~CGzipDataSink();
+
+        bool Valid() const noexcept;
+        bool Threaded() const noexcept;
+        std::size_t BytesIn() const noexcept;
+        // Compressed bytes passed to the sink so far; complete after Flush or Close
+        std::size_t BytesOut() const noexcept;
+        // Passes all data written so far to the sink as a decodable prefix
+        bool Flush() noexcept;
+        // Finishes the gzip stream; later writes fail
+        bool Close() noexcept;
+
+        bool Put(const char &ch) noexcept override;
+        bool Write(const std::vector<char> &buf) noexcept override;
+        bool Write(const char *buf, std::size_t length) noexcept override;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef MMAPDATASOURCE_H
+#define MMAPDATASOURCE_H
+
+#include "DataSource.h"
+#include <string>
+
+class CMMapDataSource : public CDataSource{
+    private:
+        const char *DData;
+        std::size_t DSize;
+        std::size_t DIndex;
+        bool DValid;
+    public:
+        CMMapDataSource(const std::string &path);
+        CMMapDataSource(const CMMapDataSource &) = delete;
+        CMMapDataSource &operator=(const CMMapDataSource &) = delete;
+        ~CMMapDataSource();
+
+        bool Valid() const noexcept;
+        // Whole mapped file, valid for the lifetime of the source
+        const char *Data() const noexcept;
+        std::size_t Size() const noexcept;
+        std::size_t Position() const noexcept;
+        std::size_t Skip(std::size_t count) noexcept;
+
+        bool End() const noexcept override;
+        bool Get(char &ch) noexcept override;
+        bool Peek(char &ch) noexcept override;
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+        std::size_t Read(char *buf, std::size_t capacity) noexcept override;
+        std::string_view Contents() const noexcept override;
+};
+
+#endif
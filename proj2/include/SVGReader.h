@@ -0,0 +1,45 @@
+#ifndef SVGREADER_H
+#define SVGREADER_H
+
+#include <memory>
+#include <string_view>
+#include "SVGWriter.h"
+#include "XMLReader.h"
+
+struct SSVGShape{
+    enum class EType{Circle, Rectangle, Line, Document, GroupBegin, GroupEnd};
+    EType DType;
+    // Circle center, rectangle top left corner or line start
+    SSVGPoint DPoint;
+    // Line end
+    SSVGPoint DEnd;
+    // Rectangle size, or the document size for the root svg element
+    SSVGSize DSize;
+    // Circle radius
+    TSVGReal DRadius;
+    // Value of the style attribute, valid until the next read
+    std::string_view DStyle;
+};
+
+// Reads the geometry of the basic shapes svg.c writes, parsing numbers
+// straight from the attribute bytes. ReadShape skips all other entities,
+// ReadElement also reports the svg and g elements that structure them
+class CSVGReader{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CSVGReader(std::shared_ptr< CDataSource > src, std::size_t chunksize = CXMLReader::DefaultChunkSize, std::size_t threads = 1, bool fasttokenizer = false);
+        ~CSVGReader();
+
+        bool End() const;
+        bool ReadShape(SSVGShape &shape);
+        bool ReadElement(SSVGShape &shape);
+        // Entity of the last element read, valid until the next read
+        const SXMLEntityView &Entity() const noexcept;
+        std::size_t SkippedShapes() const noexcept;
+        CXMLReader &Reader();
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef SVGSCENE_H
+#define SVGSCENE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "SVGReader.h"
+
+// Shapes of an SVG document as structure of arrays, one array per field so
+// that passes over a single field touch contiguous memory and the arrays
+// can be handed straight to the CSVGWriter batch calls
+struct SSVGScene{
+    using TIndex = std::uint32_t;
+
+    struct SCircles{
+        std::vector<TSVGCoordinate> DX;
+        std::vector<TSVGCoordinate> DY;
+        std::vector<TSVGReal> DRadius;
+        std::vector<TIndex> DStyle;
+
+        std::size_t Size() const noexcept{
+            return DX.size();
+        };
+    };
+
+    struct SRectangles{
+        std::vector<TSVGCoordinate> DX;
+        std::vector<TSVGCoordinate> DY;
+        std::vector<TSVGReal> DWidth;
+        std::vector<TSVGReal> DHeight;
+        std::vector<TIndex> DStyle;
+
+        std::size_t Size() const noexcept{
+            return DX.size();
+        };
+    };
+
+    struct SLines{
+        std::vector<TSVGCoordinate> DX1;
+        std::vector<TSVGCoordinate> DY1;
+        std::vector<TSVGCoordinate> DX2;
+        std::vector<TSVGCoordinate> DY2;
+        std::vector<TIndex> DStyle;
+
+        std::size_t Size() const noexcept{
+            return DX1.size();
+        };
+    };
+
+    // Draw order entry. For shapes, DCount consecutive entries of the DType
+    // array starting at DBegin that share a style; for GroupBegin and
+    // GroupEnd, DBegin is the index of the group
+    struct SRun{
+        SSVGShape::EType DType;
+        TIndex DBegin;
+        TIndex DCount;
+        TIndex DStyle;
+    };
+
+    // A g element; its contents are the runs in [DRunBegin, DRunEnd),
+    // bracketed by its own GroupBegin and GroupEnd runs. In a scene built
+    // from part of a document, groups opened before it have no GroupBegin
+    // run and their GroupEnd run has DBegin NoParent
+    struct SGroup{
+        TAttributes DAttributes;
+        TIndex DParent;
+        TIndex DRunBegin;
+        TIndex DRunEnd;
+    };
+
+    static constexpr TIndex NoParent = UINT32_MAX;
+
+    SSVGSize DSize = {0, 0};
+    // Distinct style strings, DStyles[0] is the empty style
+    std::vector<std::string> DStyles;
+    SCircles DCircles;
+    SRectangles DRectangles;
+    SLines DLines;
+    std::vector<SRun> DRuns;
+    std::vector<SGroup> DGroups;
+
+    void Clear();
+    std::size_t ShapeCount() const noexcept;
+    // Heap bytes held by the scene
+    std::size_t MemoryUsage() const noexcept;
+};
+
+// Appends elements from a CSVGReader to a scene in draw order
+class CSVGSceneBuilder{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // Clears scene and starts building into it
+        CSVGSceneBuilder(SSVGScene &scene);
+        ~CSVGSceneBuilder();
+
+        // Adds shape, with entity the element it was read from
+        void Add(const SSVGShape &shape, const SXMLEntityView &entity);
+        // Fills in the style table; no elements may be added afterwards
+        void Finish();
+};
+
+class CSVGSceneLoader{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CSVGSceneLoader(std::size_t chunksize = CXMLReader::DefaultChunkSize, std::size_t threads = 1, bool fasttokenizer = false);
+        ~CSVGSceneLoader();
+
+        bool Load(std::shared_ptr< CDataSource > src, SSVGScene &scene);
+        std::size_t SkippedShapes() const noexcept;
+};
+
+#endif
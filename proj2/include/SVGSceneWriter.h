@@ -0,0 +1,31 @@
+#ifndef SVGSCENEWRITER_H
+#define SVGSCENEWRITER_H
+
+#include <functional>
+#include <memory>
+#include "DataSink.h"
+#include "SVGScene.h"
+
+// Writes scenes back out through CSVGWriter, one batch call per run with
+// each distinct style string registered with the writer once
+class CSVGSceneWriter{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // Called on the reading thread for every shape; returns false to drop
+        // the shape, and may modify it before it is written
+        using TShapeFilter = std::function< bool(SSVGShape &shape, const SXMLEntityView &entity) >;
+
+        static constexpr std::size_t DefaultBatchSize = 4096;
+        static constexpr std::size_t DefaultQueueDepth = 4;
+
+        CSVGSceneWriter(std::shared_ptr< CDataSink > sink);
+        ~CSVGSceneWriter();
+
+        bool Write(const SSVGScene &scene);
+        bool Pipe(std::shared_ptr< CDataSource > src, TShapeFilter filter = nullptr, std::size_t batchsize = DefaultBatchSize, std::size_t queuedepth = DefaultQueueDepth);
+};
+
+#endif
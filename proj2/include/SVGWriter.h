@@ -1,6 +1,7 @@
 #ifndef SVGWRITER_H
 #define SVGWRITER_H
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include "DataSink.h"
@@ -20,21 +21,82 @@ struct SSVGSize{
     TSVGReal DHeight;
 };
 
+struct SSVGPathOptions{
+    static constexpr int ShortestPrecision = -1;
+
+    // Writes points after the first relative to the previous one
+    bool DRelative = false;
+    // Inner points this close to the last point kept, or to the line from
+    // it to the next point, are dropped; 0 keeps every point
+    TSVGReal DTolerance = 0;
+    // Decimal places, or ShortestPrecision for the shortest exact text
+    int DPrecision = ShortestPrecision;
+};
+
+// Style serialised once by CSVGWriter::RegisterStyle, only valid with the
+// writer that returned it
+struct SSVGStyleHandle{
+    std::uint32_t DIndex;
+
+    explicit SSVGStyleHandle(std::uint32_t index) : DIndex(index){};
+};
+
 class CSVGWriter{
     private:
         struct SImplementation;
         std::unique_ptr<SImplementation> DImplementation;
         
     public:
-        CSVGWriter(std::shared_ptr< CDataSink > sink, TSVGPixel width, TSVGPixel height);
+        struct SStyleCacheStats{
+            std::size_t DSize;
+            std::size_t DHits;
+            std::size_t DMisses;
+
+            double HitRate() const noexcept{
+                return DHits + DMisses ? double(DHits) / (DHits + DMisses) : 0.0;
+            };
+        };
+
+        // Point reduction applied by SimplePath and Path for the canvas
+        // resolution: MinMax keeps the first, last, lowest and highest
+        // point of each pixel column, LTTB two points per pixel of width
+        enum class EDecimation{None, MinMax, LTTB};
+
+        // Number of serialised TAttributes styles kept, least recently used
+        // first out; 0 serialises every style on every call
+        static constexpr std::size_t DefaultStyleCacheSize = 64;
+
+        CSVGWriter(std::shared_ptr< CDataSink > sink, TSVGPixel width, TSVGPixel height, std::size_t stylecachesize = DefaultStyleCacheSize);
         ~CSVGWriter();
         
         bool Circle(const SSVGPoint &center, TSVGReal radius, const TAttributes &style);
         bool Rectange(const SSVGPoint &topleft, const SSVGSize &size, const TAttributes &style);
         bool Line(const SSVGPoint &start, const SSVGPoint &end, const TAttributes &style);
-        bool SimplePath(const std::vector<SSVGPoint> points, const TAttributes &style);
+        bool SimplePath(const std::vector<SSVGPoint> &points, const TAttributes &style);
+        // Writes count points as a single path element
+        bool Path(const SSVGPoint *points, std::size_t count, const SSVGPathOptions &options, const TAttributes &style);
+        bool Circles(const TSVGCoordinate *cx, const TSVGCoordinate *cy, const TSVGReal *radius, std::size_t count, const TAttributes &style);
+        bool Rectangles(const TSVGCoordinate *x, const TSVGCoordinate *y, const TSVGReal *width, const TSVGReal *height, std::size_t count, const TAttributes &style);
+        bool Lines(const TSVGCoordinate *x1, const TSVGCoordinate *y1, const TSVGCoordinate *x2, const TSVGCoordinate *y2, std::size_t count, const TAttributes &style);
+
+        // Serialises style once for use with the handle overloads below,
+        // which skip the cache lookup entirely
+        SSVGStyleHandle RegisterStyle(const TAttributes &style);
+        // Registers style attribute text such as "fill:red;stroke:blue" as
+        // is; it is only escaped, not split into properties
+        SSVGStyleHandle RegisterStyleString(const std::string &style);
+        bool Circle(const SSVGPoint &center, TSVGReal radius, SSVGStyleHandle style);
+        bool Rectange(const SSVGPoint &topleft, const SSVGSize &size, SSVGStyleHandle style);
+        bool Line(const SSVGPoint &start, const SSVGPoint &end, SSVGStyleHandle style);
+        bool Circles(const TSVGCoordinate *cx, const TSVGCoordinate *cy, const TSVGReal *radius, std::size_t count, SSVGStyleHandle style);
+        bool Rectangles(const TSVGCoordinate *x, const TSVGCoordinate *y, const TSVGReal *width, const TSVGReal *height, std::size_t count, SSVGStyleHandle style);
+        bool Lines(const TSVGCoordinate *x1, const TSVGCoordinate *y1, const TSVGCoordinate *x2, const TSVGCoordinate *y2, std::size_t count, SSVGStyleHandle style);
+        bool Path(const SSVGPoint *points, std::size_t count, const SSVGPathOptions &options, SSVGStyleHandle style);
+        SStyleCacheStats StyleCacheStats() const noexcept;
+        bool SetDecimation(EDecimation mode);
         bool GroupBegin(const TAttributes &attrs);
         bool GroupEnd();
+        bool Flush();
 
 };
 
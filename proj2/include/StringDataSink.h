@@ -3,15 +3,27 @@
 
 #include "DataSink.h"
 #include <string>
+#include <string_view>
 
 class CStringDataSink : public CDataSink{
     private:
         std::string DString;
+        std::size_t DReallocationCount;
+        std::size_t DPeakCapacity;
+
+        bool Append(const char *buf, std::size_t length) noexcept;
     public:
+        explicit CStringDataSink(std::size_t capacity = 0);
+
         const std::string &String() const;
+        std::string_view StringView() const noexcept;
+        std::string TakeString() noexcept;
+        std::size_t ReallocationCount() const noexcept;
+        std::size_t PeakCapacity() const noexcept;
 
         bool Put(const char &ch) noexcept override;
         bool Write(const std::vector<char> &buf) noexcept override;
+        bool Write(const char *buf, std::size_t length) noexcept override;
 };
 
 #endif
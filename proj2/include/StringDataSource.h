@@ -15,6 +15,8 @@ class CStringDataSource : public CDataSource{
         bool Get(char &ch) noexcept override;
         bool Peek(char &ch) noexcept override;
         bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+        std::size_t Read(char *buf, std::size_t capacity) noexcept override;
+        std::string_view Contents() const noexcept override;
 };
 
 #endif
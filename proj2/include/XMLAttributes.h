@@ -0,0 +1,159 @@
+#ifndef XMLATTRIBUTES_H
+#define XMLATTRIBUTES_H
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using TAttribute = std::pair< std::string, std::string >;
+using TAttributes = std::vector< TAttribute >;
+
+// Attribute list that keeps insertion order in one flat array. Lookups scan
+// the array while it holds at most IndexThreshold entries; above that an
+// open addressed hash index of entry positions is kept alongside it.
+class CXMLAttributes{
+    public:
+        static constexpr std::size_t IndexThreshold = 8;
+        using const_iterator = TAttributes::const_iterator;
+
+    private:
+        TAttributes DEntries;
+        // Position + 1 of an entry, 0 for an empty slot; size is a power of 2
+        std::vector< std::uint32_t > DSlots;
+
+        static std::size_t Hash(std::string_view name) noexcept{
+            return std::hash<std::string_view>()(name);
+        };
+
+        void IndexEntry(std::size_t index) noexcept{
+            std::size_t Mask = DSlots.size() - 1;
+            std::size_t Slot = Hash(DEntries[index].first) & Mask;
+            while(DSlots[Slot]){
+                Slot = (Slot + 1) & Mask;
+            }
+            DSlots[Slot] = std::uint32_t(index + 1);
+        };
+
+        void Rebuild(){
+            std::size_t SlotCount = 16;
+            while(SlotCount < DEntries.size() * 2){
+                SlotCount *= 2;
+            }
+            DSlots.assign(SlotCount, 0);
+            for(std::size_t Index = 0; Index < DEntries.size(); Index++){
+                IndexEntry(Index);
+            }
+        };
+
+        std::size_t IndexOf(std::string_view name) const noexcept{
+            if(DSlots.empty()){
+                for(std::size_t Index = 0; Index < DEntries.size(); Index++){
+                    if(DEntries[Index].first == name){
+                        return Index;
+                    }
+                }
+                return DEntries.size();
+            }
+            std::size_t Mask = DSlots.size() - 1;
+            for(std::size_t Slot = Hash(name) & Mask; DSlots[Slot]; Slot = (Slot + 1) & Mask){
+                if(DEntries[DSlots[Slot] - 1].first == name){
+                    return DSlots[Slot] - 1;
+                }
+            }
+            return DEntries.size();
+        };
+
+    public:
+        CXMLAttributes() = default;
+
+        CXMLAttributes(std::initializer_list< TAttribute > attrs){
+            for(auto &Attribute : attrs){
+                Set(Attribute.first, Attribute.second);
+            }
+        };
+
+        std::size_t size() const noexcept{
+            return DEntries.size();
+        };
+
+        bool empty() const noexcept{
+            return DEntries.empty();
+        };
+
+        const_iterator begin() const noexcept{
+            return DEntries.begin();
+        };
+
+        const_iterator end() const noexcept{
+            return DEntries.end();
+        };
+
+        const TAttribute &operator[](std::size_t index) const noexcept{
+            return DEntries[index];
+        };
+
+        void reserve(std::size_t count){
+            DEntries.reserve(count);
+        };
+
+        void clear() noexcept{
+            DEntries.clear();
+            DSlots.clear();
+        };
+
+        // Appends without checking for an existing entry of the same name,
+        // for callers such as the reader whose names are already unique
+        void emplace_back(std::string name, std::string value){
+            DEntries.emplace_back(std::move(name), std::move(value));
+            if(DSlots.empty()){
+                if(DEntries.size() > IndexThreshold){
+                    Rebuild();
+                }
+            }
+            else if(DEntries.size() * 2 > DSlots.size()){
+                Rebuild();
+            }
+            else{
+                IndexEntry(DEntries.size() - 1);
+            }
+        };
+
+        void push_back(const TAttribute &attr){
+            emplace_back(attr.first, attr.second);
+        };
+
+        // Value of name or nullptr, valid until the attributes are modified
+        const std::string *Find(std::string_view name) const noexcept{
+            std::size_t Index = IndexOf(name);
+            return Index < DEntries.size() ? &DEntries[Index].second : nullptr;
+        };
+
+        bool Exists(std::string_view name) const noexcept{
+            return IndexOf(name) < DEntries.size();
+        };
+
+        // Replaces the value of an existing name, otherwise appends it
+        void Set(std::string_view name, std::string_view value){
+            std::size_t Index = IndexOf(name);
+            if(Index < DEntries.size()){
+                DEntries[Index].second.assign(value);
+            }
+            else{
+                emplace_back(std::string(name), std::string(value));
+            }
+        };
+
+        bool operator==(const CXMLAttributes &other) const{
+            return DEntries == other.DEntries;
+        };
+
+        bool operator!=(const CXMLAttributes &other) const{
+            return DEntries != other.DEntries;
+        };
+};
+
+#endif
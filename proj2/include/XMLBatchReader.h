@@ -0,0 +1,36 @@
+#ifndef XMLBATCHREADER_H
+#define XMLBATCHREADER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "XMLReader.h"
+
+// Parses many independent documents concurrently. Documents are handed to
+// a pool of worker threads, each with its own CXMLReader, and idle workers
+// steal pending documents from busy ones. Every document is parsed start to
+// finish by a single worker, so its entities are always delivered in
+// document order; the interleaving between documents is unspecified.
+class CXMLBatchReader{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // Called on a worker thread for each entity of document index; name
+        // IDs in entity refer to that worker's reader and are not comparable
+        // across documents
+        using TEntityCallback = std::function<void(std::size_t document, const SXMLEntityView &entity)>;
+
+        explicit CXMLBatchReader(std::size_t threads = 0, std::size_t chunksize = CXMLReader::DefaultChunkSize);
+        ~CXMLBatchReader();
+
+        std::size_t ThreadCount() const noexcept;
+
+        void Ingest(const std::vector< std::shared_ptr< CDataSource > > &sources, TEntityCallback callback, bool skipcdata = false);
+        bool IngestFiles(const std::vector< std::string > &paths, TEntityCallback callback, bool skipcdata = false);
+        std::vector< std::vector< SXMLEntity > > Ingest(const std::vector< std::shared_ptr< CDataSource > > &sources, bool skipcdata = false);
+};
+
+#endif
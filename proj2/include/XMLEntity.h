@@ -1,49 +1,138 @@
 #ifndef XMLENTITY_H
 #define XMLENTITY_H
 
+#include "XMLAttributes.h"
+#include <charconv>
+#include <cstdint>
 #include <utility>
 #include <string>
+#include <string_view>
 #include <vector>
 
-using TAttribute = std::pair< std::string, std::string >;
-using TAttributes = std::vector< TAttribute >;
+using TAttributeView = std::pair< std::string_view, std::string_view >;
+using TAttributeViews = std::vector< TAttributeView >;
+using TXMLNameID = std::uint32_t;
+
+constexpr TXMLNameID InvalidXMLNameID = UINT32_MAX;
+
+// Parses an attribute value holding a single number straight from its bytes.
+// Surrounding whitespace and a leading '+' are allowed, anything else that
+// is not part of the number (including units) makes it fail.
+inline bool XMLParseReal(std::string_view text, double &value) noexcept{
+    const char *First = text.data();
+    const char *Last = First + text.size();
+    auto IsSpace = [](char ch){
+        return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+    };
+    while(First < Last && IsSpace(*First)){
+        First++;
+    }
+    while(First < Last && IsSpace(Last[-1])){
+        Last--;
+    }
+    // from_chars would also take "inf" and "nan", which SVG numbers exclude
+    const char *Digits = First < Last && (*First == '+' || *First == '-') ? First + 1 : First;
+    if(First < Last && *First == '+'){
+        First++;
+    }
+    if(Digits == Last || (*Digits != '.' && (*Digits < '0' || *Digits > '9'))){
+        return false;
+    }
+    double Result;
+    auto [End, Error] = std::from_chars(First, Last, Result);
+    if(Error != std::errc() || End != Last){
+        return false;
+    }
+    value = Result;
+    return true;
+}
 
 struct SXMLEntity{    
     enum class EType{StartElement, EndElement, CharData, CompleteElement};
     EType DType;
     std::string DNameData;
-    TAttributes DAttributes;
+    CXMLAttributes DAttributes;
     
-    bool AttributeExists(const std::string &name) const{
+    bool AttributeExists(std::string_view name) const{
+        return DAttributes.Exists(name);
+    };
+    
+    // Returns an empty string for a missing attribute
+    const std::string &AttributeValue(std::string_view name) const{
+        static const std::string Empty;
+        const std::string *Value = DAttributes.Find(name);
+        return Value ? *Value : Empty;
+    };
+    
+    bool SetAttribute(const std::string &name, const std::string &value){
+        if(name.empty()){
+            return false;   
+        }
+        DAttributes.Set(name, value);
+        return true;
+    };
+
+    // Leaves value unchanged if the attribute is missing or not a number
+    bool TryGetReal(std::string_view name, double &value) const{
+        const std::string *Text = DAttributes.Find(name);
+        return Text && XMLParseReal(*Text, value);
+    };
+};
+
+// Non-owning entity whose strings point into storage owned by the reader
+// that produced it; valid until the next read from that reader. Element and
+// attribute names are interned, DNameID is InvalidXMLNameID for CharData and
+// DAttributeIDs holds the name ID of each entry in DAttributes.
+struct SXMLEntityView{
+    SXMLEntity::EType DType;
+    std::string_view DNameData;
+    TXMLNameID DNameID = InvalidXMLNameID;
+    TAttributeViews DAttributes;
+    std::vector< TXMLNameID > DAttributeIDs;
+
+    bool AttributeExists(std::string_view name) const{
         for(auto &Attribute : DAttributes){
             if(std::get<0>(Attribute) == name){
-                return true;   
+                return true;
             }
         }
         return false;
     };
-    
-    std::string AttributeValue(const std::string &name) const{
+
+    std::string_view AttributeValue(std::string_view name) const{
         for(auto &Attribute : DAttributes){
             if(std::get<0>(Attribute) == name){
-                return std::get<1>(Attribute);   
+                return std::get<1>(Attribute);
             }
         }
-        return std::string();
+        return std::string_view();
     };
-    
-    bool SetAttribute(const std::string &name, const std::string &value){
-        if(name.empty()){
-            return false;   
-        }
-        for(std::vector< TAttribute >::size_type Index = 0; Index < DAttributes.size(); Index++){
-            if(std::get<0>(DAttributes[Index]) == name){
-                DAttributes[Index] = std::make_pair(name,value);
+
+    bool AttributeExists(TXMLNameID id) const{
+        for(auto AttributeID : DAttributeIDs){
+            if(AttributeID == id){
                 return true;
             }
         }
-        DAttributes.push_back(std::make_pair(name,value));
-        return true;
+        return false;
+    };
+
+    std::string_view AttributeValue(TXMLNameID id) const{
+        for(std::size_t Index = 0; Index < DAttributeIDs.size(); Index++){
+            if(DAttributeIDs[Index] == id){
+                return std::get<1>(DAttributes[Index]);
+            }
+        }
+        return std::string_view();
+    };
+
+    // Leaves value unchanged if the attribute is missing or not a number
+    bool TryGetReal(std::string_view name, double &value) const{
+        return AttributeExists(name) && XMLParseReal(AttributeValue(name), value);
+    };
+
+    bool TryGetReal(TXMLNameID id, double &value) const{
+        return AttributeExists(id) && XMLParseReal(AttributeValue(id), value);
     };
 };
    
@@ -0,0 +1,41 @@
+#ifndef XMLNAMETABLE_H
+#define XMLNAMETABLE_H
+
+#include "XMLEntity.h"
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+class CXMLNameTable{
+    private:
+        std::deque<std::string> DNames;
+        std::unordered_map<std::string_view, TXMLNameID> DIndex;
+        std::size_t DLookups;
+        std::size_t DHits;
+    public:
+        struct SStats{
+            std::size_t DSize;
+            std::size_t DLookups;
+            std::size_t DHits;
+
+            double HitRate() const noexcept{
+                return DLookups ? double(DHits) / DLookups : 0.0;
+            };
+        };
+
+        explicit CXMLNameTable(bool preloadsvg = true);
+        CXMLNameTable(const CXMLNameTable &) = delete;
+        CXMLNameTable &operator=(const CXMLNameTable &) = delete;
+
+        // Returns the ID of name, adding it if it has not been seen before
+        TXMLNameID Intern(std::string_view name);
+        // Returns the ID of name or InvalidXMLNameID without adding it
+        TXMLNameID Find(std::string_view name) const noexcept;
+        // Interned text of id, valid for the lifetime of the table
+        std::string_view Name(TXMLNameID id) const noexcept;
+        std::size_t Size() const noexcept;
+        SStats Stats() const noexcept;
+};
+
+#endif
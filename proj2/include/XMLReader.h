@@ -5,17 +5,25 @@
 #include "XMLEntity.h"
 #include "DataSource.h"
 
+class CXMLNameTable;
+
 class CXMLReader{
     private:
         struct SImplementation;
         std::unique_ptr<SImplementation> DImplementation;
         
     public:
-        CXMLReader(std::shared_ptr< CDataSource > src);
+        static constexpr std::size_t DefaultChunkSize = 65536;
+
+        CXMLReader(std::shared_ptr< CDataSource > src, std::size_t chunksize = DefaultChunkSize, std::size_t maxchardata = 0, std::size_t threads = 1, bool fasttokenizer = false);
         ~CXMLReader();
+
+        void Reset(std::shared_ptr< CDataSource > src);
         
         bool End() const;
         bool ReadEntity(SXMLEntity &entity, bool skipcdata = false);
+        bool ReadEntityView(SXMLEntityView &entity, bool skipcdata = false);
+        CXMLNameTable &NameTable();
 };
 
 #endif
@@ -8,6 +8,8 @@
 #ifndef SVG_H
 #define SVG_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C"{
 #endif
@@ -37,7 +39,8 @@ typedef enum {
     SVG_ERR_NULL,          /**< NULL pointer passed */
     SVG_ERR_IO,            /**< Write callback failed */
     SVG_ERR_INVALID_ARG,   /**< Invalid parameter value */
-    SVG_ERR_STATE          /**< Invalid context state */
+    SVG_ERR_STATE,         /**< Invalid context state */
+    SVG_ERR_MEMORY         /**< Memory allocation failed */
 } svg_return_t;
 
 /**
@@ -84,10 +87,38 @@ typedef struct{
     svg_coord_t height; /**< Y length */
 } svg_size_t;
 
+/**
+ * @brief Polyline decimation applied by svg_decimate() and svg_path().
+ */
+typedef enum {
+    SVG_DECIMATE_NONE = 0,  /**< Every point is kept */
+    SVG_DECIMATE_MINMAX,    /**< First, last, lowest and highest point of each pixel column */
+    SVG_DECIMATE_LTTB       /**< Largest-triangle-three-buckets, two points per pixel of width */
+} svg_decimate_t;
+
+/**
+ * @brief Callback receiving the points kept by svg_decimate().
+ *
+ * @param user  User-defined context pointer
+ * @param point Next point kept
+ *
+ * @return Status code; anything but SVG_OK stops the decimation
+ */
+typedef svg_return_t (*svg_point_fn)(svg_user_context_ptr user,
+                                    const svg_point_t *point);
+
+/**
+ * @brief Default size in bytes of the context output buffer.
+ *
+ * Used by svg_create(). Elements are accumulated in the buffer and handed to
+ * the write callback only when it fills up, on svg_flush(), or on svg_destroy().
+ */
+#define SVG_DEFAULT_BUFFER_SIZE 65536
+
 /**
  * @brief Callback used to write SVG output.
  *
- * Called by the SVG context whenever text output is required.
+ * Called by the SVG context whenever buffered text output is flushed.
  *
  * @param user User-defined context pointer
  * @param text Null-terminated SVG text
@@ -128,11 +159,77 @@ svg_context_ptr svg_create(svg_write_fn write_fn,
                            svg_px_t width, 
                            svg_px_t height);
 
+/**
+ * @brief Creates a new SVG drawing context with a sized output buffer.
+ *
+ * Same as svg_create(), but the size of the internal output buffer is given
+ * explicitly. A buffer_size of zero disables buffering, so every element is
+ * passed to write_fn in one call as soon as it is formatted.
+ *
+ * @param write_fn    Callback used to write SVG text output
+ * @param cleanup_fn  Callback used to clean up user resources
+ * @param user        User-defined context passed to callbacks
+ * @param width       Canvas width in pixels
+ * @param height      Canvas height in pixels
+ * @param buffer_size Output buffer size in bytes (0 for unbuffered)
+ *
+ * @return Pointer to a newly created SVG context, or NULL on failure
+ */
+svg_context_ptr svg_create_buffered(svg_write_fn write_fn,
+                                    svg_cleanup_fn cleanup_fn,
+                                    svg_user_context_ptr user,
+                                    svg_px_t width,
+                                    svg_px_t height,
+                                    size_t buffer_size);
+
+/**
+ * @brief Flushes buffered output.
+ *
+ * Passes any text held in the context output buffer to the write callback.
+ * Once a write or an element buffer allocation fails, the context keeps the
+ * error: later flushes, elements and svg_destroy() return it instead of
+ * writing more output.
+ *
+ * @param context SVG context to flush
+ *
+ * @return Status code indicating success or failure
+ */
+svg_return_t svg_flush(svg_context_ptr context);
+
+/**
+ * @brief Sets the number precision of an SVG context.
+ *
+ * Controls how coordinates and lengths are written. Pass
+ * SVG_PRECISION_SHORTEST (the default) for the shortest text that
+ * round-trips, or a number of decimal places from 0 to SVG_PRECISION_MAX
+ * (see svg_number.h).
+ *
+ * @param context   SVG context to configure
+ * @param precision Precision to use for subsequent elements
+ *
+ * @return Status code indicating success or failure
+ */
+svg_return_t svg_set_precision(svg_context_ptr context, int precision);
+
+/**
+ * @brief Sets the polyline decimation mode of the context.
+ *
+ * Decimation drops points of long polylines that cannot change the
+ * rendered image at the canvas resolution. Contexts start with
+ * SVG_DECIMATE_NONE.
+ *
+ * @param context SVG context to modify
+ * @param mode    Decimation mode
+ *
+ * @return Status code indicating success or failure
+ */
+svg_return_t svg_set_decimation(svg_context_ptr context, svg_decimate_t mode);
+
 /**
  * @brief Destroys an SVG context.
  *
- * Finalizes the SVG output and releases all resources associated
- * with the context.
+ * Flushes buffered output, finalizes the SVG output and releases all
+ * resources associated with the context.
  *
  * @param context SVG context to destroy
  *
@@ -157,6 +254,29 @@ svg_return_t svg_circle(svg_context_ptr context,
                         svg_real_t radius,
                         const char* style);
 
+/**
+ * @brief Draws a batch of circles.
+ *
+ * Writes count SVG <circle> elements that share one style. Coordinates are
+ * given as separate contiguous arrays (structure of arrays), which are
+ * validated once and formatted in a single pass.
+ *
+ * @param context SVG context to draw into
+ * @param cx      Array of count center x coordinates
+ * @param cy      Array of count center y coordinates
+ * @param radius  Array of count radii
+ * @param count   Number of circles
+ * @param style   SVG style string shared by all circles (may be NULL)
+ *
+ * @return Status code indicating success or failure
+ */
+svg_return_t svg_circles(svg_context_ptr context,
+                         const svg_coord_t *cx,
+                         const svg_coord_t *cy,
+                         const svg_real_t *radius,
+                         size_t count,
+                         const char *style);
+
 /**
  * @brief Draws a rectangle.
  *
@@ -175,6 +295,30 @@ svg_return_t svg_rect(svg_context_ptr context,
                       const svg_size_t *size,
                       const char *style);
 
+/**
+ * @brief Draws a batch of rectangles.
+ *
+ * Writes count SVG <rect> elements that share one style, taking each
+ * attribute from its own contiguous array.
+ *
+ * @param context SVG context to draw into
+ * @param x       Array of count top-left x coordinates
+ * @param y       Array of count top-left y coordinates
+ * @param width   Array of count widths
+ * @param height  Array of count heights
+ * @param count   Number of rectangles
+ * @param style   SVG style string shared by all rectangles (may be NULL)
+ *
+ * @return Status code indicating success or failure
+ */
+svg_return_t svg_rects(svg_context_ptr context,
+                       const svg_coord_t *x,
+                       const svg_coord_t *y,
+                       const svg_coord_t *width,
+                       const svg_coord_t *height,
+                       size_t count,
+                       const char *style);
+
 /**
  * @brief Draws a line segment.
  *
@@ -192,6 +336,94 @@ svg_return_t svg_line(svg_context_ptr context,
                       const svg_point_t *end,
                       const char *style);
 
+/**
+ * @brief Draws a batch of line segments.
+ *
+ * Writes count SVG <line> elements that share one style, taking each
+ * endpoint coordinate from its own contiguous array.
+ *
+ * @param context SVG context to draw into
+ * @param x1      Array of count start x coordinates
+ * @param y1      Array of count start y coordinates
+ * @param x2      Array of count end x coordinates
+ * @param y2      Array of count end y coordinates
+ * @param count   Number of lines
+ * @param style   SVG style string shared by all lines (may be NULL)
+ *
+ * @return Status code indicating success or failure
+ */
+svg_return_t svg_lines(svg_context_ptr context,
+                       const svg_coord_t *x1,
+                       const svg_coord_t *y1,
+                       const svg_coord_t *x2,
+                       const svg_coord_t *y2,
+                       size_t count,
+                       const char *style);
+
+/**
+ * @brief Options controlling how svg_path() encodes its points.
+ */
+typedef struct{
+    int relative;           /**< Non-zero to write points after the first as relative l dx dy */
+    svg_real_t tolerance;   /**< Distance within which points are dropped, 0 keeps every point */
+    int precision;          /**< SVG_PRECISION_SHORTEST, or number of decimal places */
+} svg_path_options_t;
+
+/**
+ * @brief Draws a polyline as a single path element.
+ *
+ * Writes one SVG <path> element whose d attribute moves to the first point
+ * and draws lines through the rest. Numbers are only separated where needed,
+ * so "L1 2 3-4" rather than "L 1,2 L 3,-4". With relative output, fixed
+ * precision deltas are taken between rounded positions so that rounding
+ * errors do not accumulate along the path.
+ *
+ * The points are first decimated by svg_decimate(). With a positive
+ * tolerance, inner points are then dropped while the segment from the last
+ * point kept to the next point stays within tolerance of every point
+ * dropped since, so no input point ends up farther than tolerance from the
+ * drawn polyline before rounding to the precision. The first and last
+ * points are always kept.
+ *
+ * @param context SVG context to draw into
+ * @param points  Array of count points
+ * @param count   Number of points, at least 2
+ * @param options Encoding options, or NULL for absolute output of every
+ *                point at the precision of the context
+ * @param style   SVG style string (may be NULL)
+ *
+ * @return Status code indicating success or failure
+ */
+svg_return_t svg_path(svg_context_ptr context,
+                      const svg_point_t *points,
+                      size_t count,
+                      const svg_path_options_t *options,
+                      const char *style);
+
+/**
+ * @brief Decimates a polyline for the canvas of the context.
+ *
+ * Passes the points kept by the context decimation mode to point_fn in
+ * order, in a single pass over the input and with fixed working memory.
+ * The first and last points are always kept. SVG_DECIMATE_MINMAX treats
+ * each unit of x as a pixel column and keeps at most four points per
+ * column, which draws the same pixels for increasing x.
+ * SVG_DECIMATE_LTTB keeps two points per pixel of canvas width.
+ *
+ * @param context  SVG context whose mode and canvas size are used
+ * @param points   Array of count points
+ * @param count    Number of points
+ * @param point_fn Callback receiving the kept points
+ * @param user     User-defined context passed to point_fn
+ *
+ * @return Status code indicating success or failure
+ */
+svg_return_t svg_decimate(svg_context_ptr context,
+                          const svg_point_t *points,
+                          size_t count,
+                          svg_point_fn point_fn,
+                          svg_user_context_ptr user);
+
 /**
  * @brief Begins an SVG group.
  *
@@ -0,0 +1,88 @@
+/**
+ * @file svg_number.h
+ * @brief Fast number formatting for SVG output.
+ *
+ * Converts svg_real_t values to the shortest decimal text that is needed,
+ * without going through the locale-aware printf family.
+ */
+
+#ifndef SVG_NUMBER_H
+#define SVG_NUMBER_H
+
+#include "svg.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief Precision value selecting shortest round-trip output.
+ *
+ * The emitted text is the shortest decimal that converts back to exactly
+ * the same svg_real_t value.
+ */
+#define SVG_PRECISION_SHORTEST (-1)
+
+/**
+ * @brief Largest supported number of fixed decimal places.
+ */
+#define SVG_PRECISION_MAX 15
+
+/**
+ * @brief Minimum size of a buffer passed to svg_format_real().
+ *
+ * Large enough for any svg_real_t value including sign, exponent and
+ * the terminating null character.
+ */
+#define SVG_NUMBER_BUFFER_SIZE 32
+
+/**
+ * @brief Formats a real number as SVG text.
+ *
+ * With a precision of SVG_PRECISION_SHORTEST the value is written using the
+ * fewest digits that round-trip. With a precision of 0 to SVG_PRECISION_MAX
+ * the value is rounded to that many decimal places and trailing zeros are
+ * dropped, so 50.0 is written as "50" at any precision. Values outside the
+ * exactly representable integer range fall back to exponent notation.
+ *
+ * @param buffer    Output buffer of at least SVG_NUMBER_BUFFER_SIZE bytes
+ * @param value     Value to format
+ * @param precision SVG_PRECISION_SHORTEST, or number of decimal places
+ *
+ * @return Number of characters written, not counting the null terminator
+ */
+size_t svg_format_real(char *buffer, svg_real_t value, int precision);
+
+/**
+ * @brief Scales an array of values for fixed-precision formatting.
+ *
+ * Multiplies each value by 10^precision. The loop carries no branches so the
+ * compiler can vectorize it; the results are passed to svg_format_scaled().
+ * For SVG_PRECISION_SHORTEST the values are copied unchanged.
+ *
+ * @param scaled    Output array of count scaled values
+ * @param values    Input array of count values
+ * @param count     Number of values
+ * @param precision SVG_PRECISION_SHORTEST, or number of decimal places
+ */
+void svg_scale_reals(svg_real_t *scaled, const svg_real_t *values, size_t count, int precision);
+
+/**
+ * @brief Formats a value prepared by svg_scale_reals().
+ *
+ * Produces the same text as svg_format_real(buffer, value, precision).
+ *
+ * @param buffer    Output buffer of at least SVG_NUMBER_BUFFER_SIZE bytes
+ * @param scaled    Value scaled by svg_scale_reals()
+ * @param value     Original unscaled value
+ * @param precision Precision passed to svg_scale_reals()
+ *
+ * @return Number of characters written, not counting the null terminator
+ */
+size_t svg_format_scaled(char *buffer, svg_real_t scaled, svg_real_t value, int precision);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
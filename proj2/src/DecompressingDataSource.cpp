@@ -0,0 +1,352 @@
+#include "DecompressingDataSource.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <zlib.h>
+#ifdef SVG_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+struct CDecompressingDataSource::SImplementation{
+    // Window bits for inflateInit2 that expect a gzip header and trailer
+    static constexpr int GzipWindowBits = 15 + 16;
+    // Blocks in the ring when prefetching: one being read, the rest ahead
+    static constexpr std::size_t RingSize = 3;
+    static constexpr std::size_t MagicSize = 4;
+
+    struct SBlock{
+        std::vector<char> DData;
+        std::size_t DLength = 0;
+    };
+
+    std::shared_ptr<CDataSource> DSource;
+    EFormat DFormat;
+
+    // Decoder state, only touched by the thread filling blocks
+    std::vector<char> DInput;
+    std::size_t DInputIndex;
+    std::size_t DInputLength;
+    z_stream DStream;
+    bool DStreamValid;
+#ifdef SVG_HAVE_ZSTD
+    ZSTD_DStream *DZstd = nullptr;
+    std::size_t DZstdHint = 0;
+#endif
+    bool DFinished;
+    bool DFailed;
+
+    // Ring of decompressed blocks; DFilled and DConsumed count blocks
+    std::vector<SBlock> DBlocks;
+    std::size_t DFilled = 0;
+    std::size_t DConsumed = 0;
+    bool DDone = false;
+    bool DDoneFailed = false;
+
+    // Reader state
+    SBlock *DCurrent = nullptr;
+    std::size_t DIndex = 0;
+    bool DEnd = false;
+    bool DError = false;
+
+    bool DPrefetch;
+    std::thread DThread;
+    std::mutex DMutex;
+    std::condition_variable DReady;
+    std::condition_variable DSpace;
+    bool DStop = false;
+
+    SImplementation(std::shared_ptr<CDataSource> src, std::size_t blocksize, bool prefetch) : DSource(src), DFormat(EFormat::Raw), DInputIndex(0), DInputLength(0), DStreamValid(false), DFinished(false), DFailed(false), DPrefetch(prefetch && src){
+        std::memset(&DStream, 0, sizeof(DStream));
+        blocksize = std::max<std::size_t>(blocksize, 1);
+        DInput.resize(std::max(blocksize, MagicSize));
+        DBlocks.resize(DPrefetch ? RingSize : 1);
+        for(auto &Block : DBlocks){
+            Block.DData.resize(blocksize);
+        }
+        if(!DSource){
+            DFinished = DFailed = true;
+        }
+        else{
+            Detect();
+        }
+        if(DPrefetch){
+            DThread = std::thread(&SImplementation::Prefetch, this);
+        }
+        Next();
+    }
+
+    ~SImplementation(){
+        if(DThread.joinable()){
+            {
+                std::lock_guard<std::mutex> Lock(DMutex);
+                DStop = true;
+                DSpace.notify_one();
+            }
+            DThread.join();
+        }
+        if(DStreamValid){
+            inflateEnd(&DStream);
+        }
+#ifdef SVG_HAVE_ZSTD
+        ZSTD_freeDStream(DZstd);
+#endif
+    }
+
+    // Reads the first bytes of the source and sets up the matching decoder
+    void Detect(){
+        while(DInputLength < MagicSize){
+            std::size_t Count = DSource->Read(DInput.data() + DInputLength, DInput.size() - DInputLength);
+            if(!Count){
+                break;
+            }
+            DInputLength += Count;
+        }
+        const unsigned char *Magic = (const unsigned char *)DInput.data();
+        if(DInputLength >= 2 && Magic[0] == 0x1f && Magic[1] == 0x8b){
+            DFormat = EFormat::Gzip;
+            DStreamValid = inflateInit2(&DStream, GzipWindowBits) == Z_OK;
+            DStream.next_in = (Bytef *)DInput.data();
+            DStream.avail_in = (uInt)DInputLength;
+            DFinished = DFailed = !DStreamValid;
+        }
+        else if(DInputLength >= 4 && Magic[0] == 0x28 && Magic[1] == 0xb5 && Magic[2] == 0x2f && Magic[3] == 0xfd){
+            DFormat = EFormat::Zstd;
+#ifdef SVG_HAVE_ZSTD
+            DZstd = ZSTD_createDStream();
+            DFinished = DFailed = !DZstd || ZSTD_isError(ZSTD_initDStream(DZstd));
+#else
+            DFinished = DFailed = true;
+#endif
+        }
+    }
+
+    // Replaces the consumed input with the next bytes of the source
+    bool Refill(){
+        DInputIndex = 0;
+        DInputLength = DSource->Read(DInput.data(), DInput.size());
+        return DInputLength;
+    }
+
+    std::size_t DecodeRaw(char *buf, std::size_t capacity){
+        std::size_t Produced = 0;
+        while(Produced < capacity){
+            if(DInputIndex == DInputLength && !Refill()){
+                DFinished = true;
+                break;
+            }
+            std::size_t Count = std::min(capacity - Produced, DInputLength - DInputIndex);
+            std::memcpy(buf + Produced, DInput.data() + DInputIndex, Count);
+            DInputIndex += Count;
+            Produced += Count;
+        }
+        return Produced;
+    }
+
+    std::size_t DecodeGzip(char *buf, std::size_t capacity){
+        DStream.next_out = (Bytef *)buf;
+        DStream.avail_out = (uInt)capacity;
+        while(DStream.avail_out){
+            if(!DStream.avail_in){
+                if(!Refill()){
+                    // The source ended inside a gzip member
+                    DFinished = DFailed = true;
+                    break;
+                }
+                DStream.next_in = (Bytef *)DInput.data();
+                DStream.avail_in = (uInt)DInputLength;
+            }
+            int Result = inflate(&DStream, Z_NO_FLUSH);
+            if(Result == Z_STREAM_END){
+                if(!DStream.avail_in && !Refill()){
+                    DFinished = true;
+                    break;
+                }
+                if(!DStream.avail_in){
+                    DStream.next_in = (Bytef *)DInput.data();
+                    DStream.avail_in = (uInt)DInputLength;
+                }
+                // Concatenated members decode as one stream, like gunzip
+                inflateReset(&DStream);
+            }
+            else if(Result != Z_OK && Result != Z_BUF_ERROR){
+                DFinished = DFailed = true;
+                break;
+            }
+        }
+        return capacity - DStream.avail_out;
+    }
+
+#ifdef SVG_HAVE_ZSTD
+    std::size_t DecodeZstd(char *buf, std::size_t capacity){
+        ZSTD_outBuffer Output{buf, capacity, 0};
+        while(Output.pos < capacity){
+            if(DInputIndex == DInputLength && !Refill()){
+                // A non-zero hint means the last frame is incomplete
+                DFinished = true;
+                DFailed = DZstdHint != 0;
+                break;
+            }
+            ZSTD_inBuffer Input{DInput.data(), DInputLength, DInputIndex};
+            DZstdHint = ZSTD_decompressStream(DZstd, &Output, &Input);
+            DInputIndex = Input.pos;
+            if(ZSTD_isError(DZstdHint)){
+                DFinished = DFailed = true;
+                break;
+            }
+        }
+        return Output.pos;
+    }
+#endif
+
+    // Decompresses the next block; an empty block marks the end of input
+    void Fill(SBlock &block){
+        block.DLength = 0;
+        if(DFinished){
+            return;
+        }
+        switch(DFormat){
+            case EFormat::Raw:  block.DLength = DecodeRaw(block.DData.data(), block.DData.size());
+                                break;
+            case EFormat::Gzip: block.DLength = DecodeGzip(block.DData.data(), block.DData.size());
+                                break;
+            case EFormat::Zstd:
+#ifdef SVG_HAVE_ZSTD
+                                block.DLength = DecodeZstd(block.DData.data(), block.DData.size());
+#endif
+                                break;
+        }
+    }
+
+    // Body of the prefetch thread: keeps the ring ahead of the reader
+    void Prefetch(){
+        std::unique_lock<std::mutex> Lock(DMutex);
+        while(true){
+            DSpace.wait(Lock, [&]{
+                return DStop || DFilled - DConsumed < RingSize;
+            });
+            if(DStop){
+                return;
+            }
+            SBlock &Block = DBlocks[DFilled % RingSize];
+            Lock.unlock();
+            Fill(Block);
+            Lock.lock();
+            if(!Block.DLength){
+                DDone = true;
+                DDoneFailed = DFailed;
+                DReady.notify_one();
+                return;
+            }
+            DFilled++;
+            DReady.notify_one();
+        }
+    }
+
+    // Releases the current block and moves to the next, setting DEnd when
+    // the input is exhausted
+    void Next(){
+        DIndex = 0;
+        if(!DPrefetch){
+            Fill(DBlocks[0]);
+            DCurrent = &DBlocks[0];
+            DEnd = !DCurrent->DLength;
+            DError = DFailed;
+            return;
+        }
+        std::unique_lock<std::mutex> Lock(DMutex);
+        if(DCurrent){
+            DConsumed++;
+            DSpace.notify_one();
+        }
+        DReady.wait(Lock, [&]{
+            return DDone || DFilled > DConsumed;
+        });
+        if(DFilled > DConsumed){
+            DCurrent = &DBlocks[DConsumed % RingSize];
+        }
+        else{
+            DCurrent = nullptr;
+            DEnd = true;
+            DError = DDoneFailed;
+        }
+    }
+
+    bool Get(char &ch){
+        if(DEnd){
+            return false;
+        }
+        ch = DCurrent->DData[DIndex++];
+        if(DIndex == DCurrent->DLength){
+            Next();
+        }
+        return true;
+    }
+
+    bool Peek(char &ch){
+        if(DEnd){
+            return false;
+        }
+        ch = DCurrent->DData[DIndex];
+        return true;
+    }
+
+    std::size_t Read(char *buf, std::size_t capacity){
+        std::size_t Count = 0;
+        while(Count < capacity && !DEnd){
+            std::size_t Chunk = std::min(capacity - Count, DCurrent->DLength - DIndex);
+            std::memcpy(buf + Count, DCurrent->DData.data() + DIndex, Chunk);
+            DIndex += Chunk;
+            Count += Chunk;
+            if(DIndex == DCurrent->DLength){
+                Next();
+            }
+        }
+        return Count;
+    }
+};
+
+CDecompressingDataSource::CDecompressingDataSource(std::shared_ptr< CDataSource > src, std::size_t blocksize, bool prefetch){
+    DImplementation = std::make_unique<SImplementation>(src, blocksize, prefetch);
+}
+
+CDecompressingDataSource::~CDecompressingDataSource(){
+
+}
+
+bool CDecompressingDataSource::Valid() const noexcept{
+    return !DImplementation->DError;
+}
+
+CDecompressingDataSource::EFormat CDecompressingDataSource::Format() const noexcept{
+    return DImplementation->DFormat;
+}
+
+bool CDecompressingDataSource::End() const noexcept{
+    return DImplementation->DEnd;
+}
+
+bool CDecompressingDataSource::Get(char &ch) noexcept{
+    return DImplementation->Get(ch);
+}
+
+bool CDecompressingDataSource::Peek(char &ch) noexcept{
+    return DImplementation->Peek(ch);
+}
+
+bool CDecompressingDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
+    try{
+        buf.resize(count);
+    }
+    catch(...){
+        buf.clear();
+        return false;
+    }
+    buf.resize(DImplementation->Read(buf.data(), count));
+    return !buf.empty();
+}
+
+std::size_t CDecompressingDataSource::Read(char *buf, std::size_t capacity) noexcept{
+    return DImplementation->Read(buf, capacity);
+}
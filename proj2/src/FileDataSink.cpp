@@ -0,0 +1,213 @@
+#include "FileDataSink.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+struct CFileDataSink::SImplementation{
+    static constexpr std::size_t DirectAlignment = 4096;
+
+    int DFileDescriptor;
+    bool DOwnsFileDescriptor;
+    bool DVectored;
+    bool DDirect;
+    bool DError;
+    char *DBuffer;
+    std::size_t DBufferSize;
+    std::size_t DBufferLength;
+    std::size_t DWriteCalls;
+
+    SImplementation(int fd, bool ownsfd, std::size_t buffersize, bool vectored, bool direct) : DFileDescriptor(fd), DOwnsFileDescriptor(ownsfd), DVectored(vectored && !direct), DDirect(direct), DError(fd < 0), DBuffer(nullptr), DBufferSize(buffersize ? buffersize : 1), DBufferLength(0), DWriteCalls(0){
+        if(DDirect){
+            // O_DIRECT needs the buffer address and every write size block aligned
+            DBufferSize = (DBufferSize + DirectAlignment - 1) / DirectAlignment * DirectAlignment;
+            void *Memory = nullptr;
+            if(posix_memalign(&Memory, DirectAlignment, DBufferSize) == 0){
+                DBuffer = (char *)Memory;
+            }
+        }
+        else{
+            DBuffer = (char *)std::malloc(DBufferSize);
+        }
+        if(!DBuffer){
+            DError = true;
+        }
+    }
+
+    ~SImplementation(){
+        Close();
+        std::free(DBuffer);
+    }
+
+    bool WriteAll(const char *buf, std::size_t length){
+        while(length){
+            DWriteCalls++;
+            ssize_t Result = write(DFileDescriptor, buf, length);
+            if(Result < 0 && errno == EINTR){
+                continue;
+            }
+            // A write that makes no progress would otherwise be retried forever
+            if(Result <= 0){
+                DError = true;
+                return false;
+            }
+            buf += Result;
+            length -= Result;
+        }
+        return true;
+    }
+
+    // Writes the buffer followed by buf with as few writev calls as possible
+    bool WriteVectored(const char *buf, std::size_t length){
+        struct iovec Vectors[2] = {{DBuffer, DBufferLength}, {(void *)buf, length}};
+        struct iovec *Current = Vectors;
+        int Count = 2;
+        DBufferLength = 0;
+        while(Count){
+            DWriteCalls++;
+            ssize_t Result = writev(DFileDescriptor, Current, Count);
+            if(Result < 0 && errno == EINTR){
+                continue;
+            }
+            if(Result <= 0){
+                DError = true;
+                return false;
+            }
+            while(Count && (std::size_t)Result >= Current->iov_len){
+                Result -= Current->iov_len;
+                Current++;
+                Count--;
+            }
+            if(Count){
+                Current->iov_base = (char *)Current->iov_base + Result;
+                Current->iov_len -= Result;
+            }
+        }
+        return true;
+    }
+
+    bool FlushBuffer(){
+        if(DError){
+            return false;
+        }
+        bool Result = WriteAll(DBuffer, DBufferLength);
+        DBufferLength = 0;
+        return Result;
+    }
+
+    bool Append(const char *buf, std::size_t length){
+        if(DError || DFileDescriptor < 0){
+            return false;
+        }
+        if(length <= DBufferSize - DBufferLength){
+            std::memcpy(DBuffer + DBufferLength, buf, length);
+            DBufferLength += length;
+            return true;
+        }
+        if(DVectored){
+            return WriteVectored(buf, length);
+        }
+        while(length){
+            std::size_t Chunk = std::min(length, DBufferSize - DBufferLength);
+            std::memcpy(DBuffer + DBufferLength, buf, Chunk);
+            DBufferLength += Chunk;
+            buf += Chunk;
+            length -= Chunk;
+            if(DBufferLength == DBufferSize && !FlushBuffer()){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Flush(){
+        if(DError){
+            return false;
+        }
+        if(DDirect){
+            // Only whole blocks can go out with O_DIRECT; the tail waits for Close
+            std::size_t Aligned = DBufferLength / DirectAlignment * DirectAlignment;
+            if(!WriteAll(DBuffer, Aligned)){
+                return false;
+            }
+            std::memmove(DBuffer, DBuffer + Aligned, DBufferLength - Aligned);
+            DBufferLength -= Aligned;
+            return true;
+        }
+        return FlushBuffer();
+    }
+
+    bool Close(){
+        if(DFileDescriptor < 0){
+            return !DError;
+        }
+        bool Result = Flush();
+        if(Result && DDirect && DBufferLength){
+            int Flags = fcntl(DFileDescriptor, F_GETFL);
+            Result = Flags >= 0 && fcntl(DFileDescriptor, F_SETFL, Flags & ~O_DIRECT) == 0 && FlushBuffer();
+        }
+        if(DOwnsFileDescriptor && close(DFileDescriptor) != 0){
+            Result = false;
+        }
+        DFileDescriptor = -1;
+        DError = DError || !Result;
+        return Result;
+    }
+};
+
+CFileDataSink::CFileDataSink(int fd, bool ownsfd, std::size_t buffersize, bool vectored){
+    DImplementation = std::make_unique<SImplementation>(fd, ownsfd, buffersize, vectored, false);
+}
+
+CFileDataSink::CFileDataSink(const std::string &path, std::size_t buffersize, bool vectored, bool direct){
+    int Flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    int FileDescriptor = -1;
+    if(direct){
+        FileDescriptor = open(path.c_str(), Flags | O_DIRECT, 0644);
+        // Filesystems such as tmpfs reject O_DIRECT; fall back to buffered I/O
+        direct = FileDescriptor >= 0;
+    }
+    if(FileDescriptor < 0){
+        FileDescriptor = open(path.c_str(), Flags, 0644);
+    }
+    DImplementation = std::make_unique<SImplementation>(FileDescriptor, true, buffersize, vectored, direct);
+}
+
+CFileDataSink::~CFileDataSink(){
+
+}
+
+bool CFileDataSink::Valid() const noexcept{
+    return !DImplementation->DError;
+}
+
+bool CFileDataSink::Direct() const noexcept{
+    return DImplementation->DDirect;
+}
+
+std::size_t CFileDataSink::WriteCalls() const noexcept{
+    return DImplementation->DWriteCalls;
+}
+
+bool CFileDataSink::Flush() noexcept{
+    return DImplementation->Flush();
+}
+
+bool CFileDataSink::Close() noexcept{
+    return DImplementation->Close();
+}
+
+bool CFileDataSink::Put(const char &ch) noexcept{
+    return DImplementation->Append(&ch, 1);
+}
+
+bool CFileDataSink::Write(const std::vector<char> &buf) noexcept{
+    return DImplementation->Append(buf.data(), buf.size());
+}
+
+bool CFileDataSink::Write(const char *buf, std::size_t length) noexcept{
+    return DImplementation->Append(buf, length);
+}
@@ -0,0 +1,262 @@
+#include "GzipDataSink.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <zlib.h>
+
+struct CGzipDataSink::SImplementation{
+    // Window bits for deflateInit2 that select a gzip header and trailer
+    static constexpr int GzipWindowBits = 15 + 16;
+    // Filled blocks waiting for the compression thread before Write blocks
+    static constexpr std::size_t QueueDepth = 2;
+
+    struct SBlock{
+        std::vector<char> DData;
+        std::size_t DLength;
+        int DFlush;
+    };
+
+    std::shared_ptr<CDataSink> DSink;
+    z_stream DStream;
+    bool DStreamValid;
+    bool DError;
+    bool DClosed;
+    std::vector<char> DInput;
+    std::size_t DInputLength;
+    std::vector<char> DOutput;
+    std::size_t DBytesIn;
+    std::atomic<std::size_t> DBytesOut;
+
+    bool DThreaded;
+    std::thread DThread;
+    std::mutex DMutex;
+    std::condition_variable DReady;
+    std::condition_variable DSpace;
+    std::deque<SBlock> DPending;
+    std::vector< std::vector<char> > DFree;
+    bool DBusy = false;
+    bool DStop = false;
+    bool DFailed = false;
+
+    SImplementation(std::shared_ptr<CDataSink> sink, int level, std::size_t buffersize, bool threaded) : DSink(sink), DStreamValid(false), DError(true), DClosed(false), DInputLength(0), DBytesIn(0), DBytesOut(0), DThreaded(false){
+        std::memset(&DStream, 0, sizeof(DStream));
+        if(!DSink || level < Z_NO_COMPRESSION || level > Z_BEST_COMPRESSION){
+            return;
+        }
+        DStreamValid = deflateInit2(&DStream, level, Z_DEFLATED, GzipWindowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+        if(!DStreamValid){
+            return;
+        }
+        buffersize = std::max<std::size_t>(buffersize, 1);
+        DInput.resize(buffersize);
+        DOutput.resize(buffersize);
+        DError = false;
+        DThreaded = threaded;
+        if(DThreaded){
+            DThread = std::thread(&SImplementation::Compress, this);
+        }
+    }
+
+    ~SImplementation(){
+        Close();
+        if(DThread.joinable()){
+            Stop();
+        }
+        if(DStreamValid){
+            deflateEnd(&DStream);
+        }
+    }
+
+    // Runs buf through deflate and writes all output produced to the sink
+    bool Deflate(const char *buf, std::size_t length, int flush){
+        DStream.next_in = (Bytef *)buf;
+        DStream.avail_in = (uInt)length;
+        do{
+            DStream.next_out = (Bytef *)DOutput.data();
+            DStream.avail_out = (uInt)DOutput.size();
+            if(deflate(&DStream, flush) == Z_STREAM_ERROR){
+                return false;
+            }
+            std::size_t Produced = DOutput.size() - DStream.avail_out;
+            if(Produced && !DSink->Write(DOutput.data(), Produced)){
+                return false;
+            }
+            DBytesOut += Produced;
+        }while(DStream.avail_out == 0);
+        return true;
+    }
+
+    // Body of the compression thread: deflates queued blocks in order
+    void Compress(){
+        std::unique_lock<std::mutex> Lock(DMutex);
+        while(true){
+            DReady.wait(Lock, [&]{
+                return DStop || !DPending.empty();
+            });
+            if(DPending.empty()){
+                return;
+            }
+            SBlock Block = std::move(DPending.front());
+            DPending.pop_front();
+            DBusy = true;
+            bool Failed = DFailed;
+            Lock.unlock();
+            if(!Failed){
+                Failed = !Deflate(Block.DData.data(), Block.DLength, Block.DFlush);
+            }
+            Lock.lock();
+            DFailed = DFailed || Failed;
+            DFree.push_back(std::move(Block.DData));
+            DBusy = false;
+            DSpace.notify_one();
+        }
+    }
+
+    // Hands the input buffer to the compression thread and takes a free one
+    bool Submit(int flush){
+        std::unique_lock<std::mutex> Lock(DMutex);
+        DSpace.wait(Lock, [&]{
+            return DFailed || DPending.size() < QueueDepth;
+        });
+        if(DFailed){
+            return false;
+        }
+        std::size_t BufferSize = DInput.size();
+        DPending.push_back({std::move(DInput), DInputLength, flush});
+        DReady.notify_one();
+        if(DFree.empty()){
+            DInput.resize(BufferSize);
+        }
+        else{
+            DInput = std::move(DFree.back());
+            DFree.pop_back();
+        }
+        DInputLength = 0;
+        return true;
+    }
+
+    // Waits until the compression thread has deflated every queued block
+    bool Wait(){
+        std::unique_lock<std::mutex> Lock(DMutex);
+        DSpace.wait(Lock, [&]{
+            return DPending.empty() && !DBusy;
+        });
+        return !DFailed;
+    }
+
+    void Stop(){
+        {
+            std::lock_guard<std::mutex> Lock(DMutex);
+            DStop = true;
+            DReady.notify_one();
+        }
+        DThread.join();
+    }
+
+    // Deflates the buffered input with the given zlib flush mode
+    bool Drain(int flush){
+        if(DThreaded){
+            return Submit(flush) && Wait();
+        }
+        std::size_t Length = DInputLength;
+        DInputLength = 0;
+        return Deflate(DInput.data(), Length, flush);
+    }
+
+    bool Append(const char *buf, std::size_t length){
+        if(DError || DClosed){
+            return false;
+        }
+        DBytesIn += length;
+        if(!DThreaded && length >= DInput.size() && length <= std::numeric_limits<uInt>::max()){
+            // zlib copies into its own window, so large spans skip the buffer
+            DError = !Drain(Z_NO_FLUSH) || !Deflate(buf, length, Z_NO_FLUSH);
+            return !DError;
+        }
+        while(length){
+            std::size_t Chunk = std::min(length, DInput.size() - DInputLength);
+            std::memcpy(DInput.data() + DInputLength, buf, Chunk);
+            DInputLength += Chunk;
+            buf += Chunk;
+            length -= Chunk;
+            if(DInputLength == DInput.size()){
+                if(DThreaded ? !Submit(Z_NO_FLUSH) : !Drain(Z_NO_FLUSH)){
+                    DError = true;
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool Flush(){
+        if(DError || DClosed){
+            return false;
+        }
+        DError = !Drain(Z_SYNC_FLUSH);
+        return !DError;
+    }
+
+    bool Close(){
+        if(DClosed){
+            return !DError;
+        }
+        DClosed = true;
+        if(!DError){
+            DError = !Drain(Z_FINISH);
+        }
+        if(DThread.joinable()){
+            Stop();
+        }
+        return !DError;
+    }
+};
+
+CGzipDataSink::CGzipDataSink(std::shared_ptr< CDataSink > sink, int level, std::size_t buffersize, bool threaded){
+    DImplementation = std::make_unique<SImplementation>(sink, level, buffersize, threaded);
+}
+
+CGzipDataSink::~CGzipDataSink(){
+
+}
+
+bool CGzipDataSink::Valid() const noexcept{
+    return !DImplementation->DError;
+}
+
+bool CGzipDataSink::Threaded() const noexcept{
+    return DImplementation->DThreaded;
+}
+
+std::size_t CGzipDataSink::BytesIn() const noexcept{
+    return DImplementation->DBytesIn;
+}
+
+std::size_t CGzipDataSink::BytesOut() const noexcept{
+    return DImplementation->DBytesOut;
+}
+
+bool CGzipDataSink::Flush() noexcept{
+    return DImplementation->Flush();
+}
+
+bool CGzipDataSink::Close() noexcept{
+    return DImplementation->Close();
+}
+
+bool CGzipDataSink::Put(const char &ch) noexcept{
+    return DImplementation->Append(&ch, 1);
+}
+
+bool CGzipDataSink::Write(const std::vector<char> &buf) noexcept{
+    return DImplementation->Append(buf.data(), buf.size());
+}
+
+bool CGzipDataSink::Write(const char *buf, std::size_t length) noexcept{
+    return DImplementation->Append(buf, length);
+}
@@ -0,0 +1,109 @@
+#include "MMapDataSource.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CMMapDataSource::CMMapDataSource(const std::string &path) : DData(nullptr), DSize(0), DIndex(0), DValid(false){
+    int FileDescriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(FileDescriptor < 0){
+        return;
+    }
+    struct stat Status;
+    if(fstat(FileDescriptor, &Status) == 0){
+        DSize = Status.st_size;
+        if(!DSize){
+            DValid = true;
+        }
+        else{
+            void *Mapping = mmap(nullptr, DSize, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+            if(Mapping != MAP_FAILED){
+                madvise(Mapping, DSize, MADV_SEQUENTIAL);
+                DData = (const char *)Mapping;
+                DValid = true;
+            }
+            else{
+                DSize = 0;
+            }
+        }
+    }
+    // The mapping stays valid after the descriptor is closed
+    close(FileDescriptor);
+}
+
+CMMapDataSource::~CMMapDataSource(){
+    if(DData){
+        munmap((void *)DData, DSize);
+    }
+}
+
+bool CMMapDataSource::Valid() const noexcept{
+    return DValid;
+}
+
+const char *CMMapDataSource::Data() const noexcept{
+    return DData;
+}
+
+std::size_t CMMapDataSource::Size() const noexcept{
+    return DSize;
+}
+
+std::size_t CMMapDataSource::Position() const noexcept{
+    return DIndex;
+}
+
+std::size_t CMMapDataSource::Skip(std::size_t count) noexcept{
+    count = std::min(count, DSize - DIndex);
+    DIndex += count;
+    return count;
+}
+
+bool CMMapDataSource::End() const noexcept{
+    return DIndex >= DSize;
+}
+
+bool CMMapDataSource::Get(char &ch) noexcept{
+    if(DIndex < DSize){
+        ch = DData[DIndex];
+        DIndex++;
+        return true;
+    }
+    return false;
+}
+
+bool CMMapDataSource::Peek(char &ch) noexcept{
+    if(DIndex < DSize){
+        ch = DData[DIndex];
+        return true;
+    }
+    return false;
+}
+
+bool CMMapDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
+    std::size_t Length = std::min(count, DSize - DIndex);
+    try{
+        buf.assign(DData + DIndex, DData + DIndex + Length);
+    }
+    catch(...){
+        buf.clear();
+        return false;
+    }
+    DIndex += Length;
+    return !buf.empty();
+}
+
+std::size_t CMMapDataSource::Read(char *buf, std::size_t capacity) noexcept{
+    std::size_t Count = std::min(capacity, DSize - DIndex);
+    if(Count){
+        std::memcpy(buf, DData + DIndex, Count);
+        DIndex += Count;
+    }
+    return Count;
+}
+
+std::string_view CMMapDataSource::Contents() const noexcept{
+    return DData ? std::string_view(DData + DIndex, DSize - DIndex) : std::string_view();
+}
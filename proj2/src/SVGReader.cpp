@@ -0,0 +1,188 @@
+#include "SVGReader.h"
+#include "XMLNameTable.h"
+
+struct CSVGReader::SImplementation{
+    // Geometry attributes, indexed by the slot their value is parsed into
+    enum EAttribute{X, Y, CX, CY, R, Width, Height, X1, Y1, X2, Y2, Style, AttributeCount};
+
+    CXMLReader DReader;
+    SXMLEntityView DEntity;
+    TXMLNameID DCircleID;
+    TXMLNameID DRectID;
+    TXMLNameID DLineID;
+    TXMLNameID DSVGID;
+    TXMLNameID DGroupID;
+    TXMLNameID DAttributeIDs[AttributeCount];
+    std::size_t DSkippedShapes = 0;
+
+    SImplementation(std::shared_ptr< CDataSource > src, std::size_t chunksize, std::size_t threads, bool fasttokenizer) : DReader(src, chunksize, 0, threads, fasttokenizer){
+        static const char *AttributeNames[AttributeCount] = {"x", "y", "cx", "cy", "r", "width", "height", "x1", "y1", "x2", "y2", "style"};
+        CXMLNameTable &Names = DReader.NameTable();
+        DCircleID = Names.Intern("circle");
+        DRectID = Names.Intern("rect");
+        DLineID = Names.Intern("line");
+        DSVGID = Names.Intern("svg");
+        DGroupID = Names.Intern("g");
+        for(int Index = 0; Index < AttributeCount; Index++){
+            DAttributeIDs[Index] = Names.Intern(AttributeNames[Index]);
+        }
+    }
+
+    // Parses the geometry of the current entity in one pass over its
+    // attributes; missing values default to 0 as in SVG
+    bool ParseShape(SSVGShape &shape){
+        TSVGReal Values[AttributeCount] = {};
+        shape.DStyle = std::string_view();
+        for(std::size_t Index = 0; Index < DEntity.DAttributeIDs.size(); Index++){
+            TXMLNameID ID = DEntity.DAttributeIDs[Index];
+            for(int Attribute = 0; Attribute < AttributeCount; Attribute++){
+                if(ID != DAttributeIDs[Attribute]){
+                    continue;
+                }
+                std::string_view Value = std::get<1>(DEntity.DAttributes[Index]);
+                if(Attribute == Style){
+                    shape.DStyle = Value;
+                }
+                else if(!XMLParseReal(Value, Values[Attribute])){
+                    return false;
+                }
+                break;
+            }
+        }
+        switch(shape.DType){
+            case SSVGShape::EType::Circle:
+                shape.DPoint = {Values[CX], Values[CY]};
+                shape.DRadius = Values[R];
+                break;
+            case SSVGShape::EType::Rectangle:
+                shape.DPoint = {Values[X], Values[Y]};
+                shape.DSize = {Values[Width], Values[Height]};
+                break;
+            case SSVGShape::EType::Line:
+                shape.DPoint = {Values[X1], Values[Y1]};
+                shape.DEnd = {Values[X2], Values[Y2]};
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    // Document sizes such as "100%" are not plain numbers; they read as 0
+    // rather than dropping the document
+    void ParseDocument(SSVGShape &shape){
+        double Value;
+        shape.DSize.DWidth = DEntity.TryGetReal(DAttributeIDs[Width], Value) ? Value : 0;
+        shape.DSize.DHeight = DEntity.TryGetReal(DAttributeIDs[Height], Value) ? Value : 0;
+        shape.DStyle = DEntity.AttributeValue(DAttributeIDs[Style]);
+    }
+
+    bool ReadElement(SSVGShape &shape, bool shapesonly){
+        while(DReader.ReadEntityView(DEntity, true)){
+            if(DEntity.DType == SXMLEntity::EType::EndElement){
+                if(!shapesonly && DEntity.DNameID == DGroupID){
+                    shape.DType = SSVGShape::EType::GroupEnd;
+                    shape.DStyle = std::string_view();
+                    return true;
+                }
+                continue;
+            }
+            if(DEntity.DType != SXMLEntity::EType::StartElement){
+                continue;
+            }
+            if(DEntity.DNameID == DCircleID){
+                shape.DType = SSVGShape::EType::Circle;
+            }
+            else if(DEntity.DNameID == DRectID){
+                shape.DType = SSVGShape::EType::Rectangle;
+            }
+            else if(DEntity.DNameID == DLineID){
+                shape.DType = SSVGShape::EType::Line;
+            }
+            else if(!shapesonly && DEntity.DNameID == DGroupID){
+                shape.DType = SSVGShape::EType::GroupBegin;
+                shape.DStyle = DEntity.AttributeValue(DAttributeIDs[Style]);
+                return true;
+            }
+            else if(!shapesonly && DEntity.DNameID == DSVGID){
+                shape.DType = SSVGShape::EType::Document;
+                ParseDocument(shape);
+                return true;
+            }
+            else{
+                continue;
+            }
+            if(ParseShape(shape)){
+                return true;
+            }
+            DSkippedShapes++;
+        }
+        return false;
+    }
+};
+/**
+ * @brief Constructs an SVG shape reader.
+ * @param src Shared pointer to the data source to read SVG from.
+ * @param chunksize Number of bytes pulled from the source per parse step.
+ * @param threads Threads used to parse a memory-resident source.
+ * @param fasttokenizer Whether to use the fast tokenizer on a memory-resident source.
+ */
+CSVGReader::CSVGReader(std::shared_ptr< CDataSource > src, std::size_t chunksize, std::size_t threads, bool fasttokenizer){
+    DImplementation = std::make_unique<SImplementation>(src, chunksize, threads, fasttokenizer);
+}
+/**
+ * @brief Destructor for the SVG shape reader.
+ */
+CSVGReader::~CSVGReader(){
+
+}
+/**
+ * @brief Checks if you reached the end of the SVG input
+ * @return True if end of SVG stream reached, false otherwise.
+ */
+bool CSVGReader::End() const{
+    return DImplementation->DReader.End();
+}
+/**
+ * @brief Reads the next circle, rect or line element.
+ *
+ * Elements whose geometry attributes are not plain numbers are skipped and
+ * counted by SkippedShapes().
+ * @param shape Reference to store the shape in.
+ * @return True if a shape was read, false at the end of the input.
+ */
+bool CSVGReader::ReadShape(SSVGShape &shape){
+    return DImplementation->ReadElement(shape, true);
+}
+/**
+ * @brief Reads the next shape, svg or g element.
+ *
+ * The root svg element is reported as Document with its width and height,
+ * g elements as a GroupBegin and GroupEnd pair around their contents.
+ * @param shape Reference to store the element in.
+ * @return True if an element was read, false at the end of the input.
+ */
+bool CSVGReader::ReadElement(SSVGShape &shape){
+    return DImplementation->ReadElement(shape, false);
+}
+/**
+ * @brief Gets the entity of the last element read.
+ * @return Reference to the entity view, valid until the next read.
+ */
+const SXMLEntityView &CSVGReader::Entity() const noexcept{
+    return DImplementation->DEntity;
+}
+/**
+ * @brief Gets the number of shape elements skipped for malformed geometry.
+ * @return Number of skipped shapes.
+ */
+std::size_t CSVGReader::SkippedShapes() const noexcept{
+    return DImplementation->DSkippedShapes;
+}
+/**
+ * @brief Gets the underlying XML reader.
+ * @return Reference to the XML reader.
+ */
+CXMLReader &CSVGReader::Reader(){
+    return DImplementation->DReader;
+}
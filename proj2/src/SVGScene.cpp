@@ -0,0 +1,244 @@
+#include "SVGScene.h"
+#include "XMLNameTable.h"
+
+namespace{
+    template <typename T> std::size_t VectorBytes(const std::vector<T> &vec){
+        return vec.capacity() * sizeof(T);
+    }
+
+    std::size_t StringBytes(const std::string &str){
+        // Short strings live inside the object itself
+        return str.capacity() > std::string().capacity() ? str.capacity() + 1 : 0;
+    }
+}
+/**
+ * @brief Removes all shapes, styles and groups from the scene.
+ *
+ * The arrays keep their capacity, so a scene that is cleared and refilled
+ * with a similar number of shapes does not reallocate them.
+ */
+void SSVGScene::Clear(){
+    DSize = {0, 0};
+    DStyles.clear();
+    DCircles.DX.clear();
+    DCircles.DY.clear();
+    DCircles.DRadius.clear();
+    DCircles.DStyle.clear();
+    DRectangles.DX.clear();
+    DRectangles.DY.clear();
+    DRectangles.DWidth.clear();
+    DRectangles.DHeight.clear();
+    DRectangles.DStyle.clear();
+    DLines.DX1.clear();
+    DLines.DY1.clear();
+    DLines.DX2.clear();
+    DLines.DY2.clear();
+    DLines.DStyle.clear();
+    DRuns.clear();
+    DGroups.clear();
+}
+/**
+ * @brief Gets the number of shapes in the scene.
+ * @return Total count of circles, rectangles and lines.
+ */
+std::size_t SSVGScene::ShapeCount() const noexcept{
+    return DCircles.Size() + DRectangles.Size() + DLines.Size();
+}
+/**
+ * @brief Gets the heap memory held by the scene.
+ * @return Number of bytes allocated by the scene's containers.
+ */
+std::size_t SSVGScene::MemoryUsage() const noexcept{
+    std::size_t Bytes = VectorBytes(DStyles) + VectorBytes(DRuns) + VectorBytes(DGroups);
+    for(auto &Style : DStyles){
+        Bytes += StringBytes(Style);
+    }
+    for(auto &Group : DGroups){
+        Bytes += VectorBytes(Group.DAttributes);
+        for(auto &Attribute : Group.DAttributes){
+            Bytes += StringBytes(std::get<0>(Attribute)) + StringBytes(std::get<1>(Attribute));
+        }
+    }
+    Bytes += VectorBytes(DCircles.DX) + VectorBytes(DCircles.DY) + VectorBytes(DCircles.DRadius) + VectorBytes(DCircles.DStyle);
+    Bytes += VectorBytes(DRectangles.DX) + VectorBytes(DRectangles.DY) + VectorBytes(DRectangles.DWidth) + VectorBytes(DRectangles.DHeight) + VectorBytes(DRectangles.DStyle);
+    Bytes += VectorBytes(DLines.DX1) + VectorBytes(DLines.DY1) + VectorBytes(DLines.DX2) + VectorBytes(DLines.DY2) + VectorBytes(DLines.DStyle);
+    return Bytes;
+}
+
+struct CSVGSceneBuilder::SImplementation{
+    SSVGScene &DScene;
+    // Interning gives each distinct style a dense index
+    CXMLNameTable DStyles;
+    std::vector<SSVGScene::TIndex> DOpenGroups;
+    bool DFoundDocument = false;
+
+    SImplementation(SSVGScene &scene) : DScene(scene), DStyles(false){
+        DScene.Clear();
+        DStyles.Intern("");
+    }
+
+    // Extends the last run if the shape continues it, otherwise starts a new one
+    void AddToRun(SSVGShape::EType type, SSVGScene::TIndex index, SSVGScene::TIndex style){
+        if(!DScene.DRuns.empty()){
+            SSVGScene::SRun &Last = DScene.DRuns.back();
+            if(Last.DType == type && Last.DStyle == style && Last.DBegin + Last.DCount == index){
+                Last.DCount++;
+                return;
+            }
+        }
+        DScene.DRuns.push_back({type, index, 1, style});
+    }
+
+    void Add(const SSVGShape &shape, const SXMLEntityView &entity){
+        SSVGScene::TIndex Style = DStyles.Intern(shape.DStyle);
+        switch(shape.DType){
+            case SSVGShape::EType::Circle:      AddToRun(shape.DType, DScene.DCircles.Size(), Style);
+                                                DScene.DCircles.DX.push_back(shape.DPoint.DX);
+                                                DScene.DCircles.DY.push_back(shape.DPoint.DY);
+                                                DScene.DCircles.DRadius.push_back(shape.DRadius);
+                                                DScene.DCircles.DStyle.push_back(Style);
+                                                break;
+            case SSVGShape::EType::Rectangle:   AddToRun(shape.DType, DScene.DRectangles.Size(), Style);
+                                                DScene.DRectangles.DX.push_back(shape.DPoint.DX);
+                                                DScene.DRectangles.DY.push_back(shape.DPoint.DY);
+                                                DScene.DRectangles.DWidth.push_back(shape.DSize.DWidth);
+                                                DScene.DRectangles.DHeight.push_back(shape.DSize.DHeight);
+                                                DScene.DRectangles.DStyle.push_back(Style);
+                                                break;
+            case SSVGShape::EType::Line:        AddToRun(shape.DType, DScene.DLines.Size(), Style);
+                                                DScene.DLines.DX1.push_back(shape.DPoint.DX);
+                                                DScene.DLines.DY1.push_back(shape.DPoint.DY);
+                                                DScene.DLines.DX2.push_back(shape.DEnd.DX);
+                                                DScene.DLines.DY2.push_back(shape.DEnd.DY);
+                                                DScene.DLines.DStyle.push_back(Style);
+                                                break;
+            case SSVGShape::EType::Document:    if(!DFoundDocument){
+                                                    DScene.DSize = shape.DSize;
+                                                    DFoundDocument = true;
+                                                }
+                                                break;
+            case SSVGShape::EType::GroupBegin:  {
+                                                    SSVGScene::SGroup Group;
+                                                    for(auto &Attribute : entity.DAttributes){
+                                                        Group.DAttributes.emplace_back(std::string(std::get<0>(Attribute)), std::string(std::get<1>(Attribute)));
+                                                    }
+                                                    Group.DParent = DOpenGroups.empty() ? SSVGScene::NoParent : DOpenGroups.back();
+                                                    Group.DRunBegin = Group.DRunEnd = DScene.DRuns.size();
+                                                    DOpenGroups.push_back(DScene.DGroups.size());
+                                                    DScene.DRuns.push_back({shape.DType, DOpenGroups.back(), 0, Style});
+                                                    DScene.DGroups.push_back(std::move(Group));
+                                                }
+                                                break;
+            case SSVGShape::EType::GroupEnd:    if(DOpenGroups.empty()){
+                                                    DScene.DRuns.push_back({shape.DType, SSVGScene::NoParent, 0, 0});
+                                                }
+                                                else{
+                                                    DScene.DRuns.push_back({shape.DType, DOpenGroups.back(), 0, 0});
+                                                    DScene.DGroups[DOpenGroups.back()].DRunEnd = DScene.DRuns.size();
+                                                    DOpenGroups.pop_back();
+                                                }
+                                                break;
+        }
+    }
+
+    void Finish(){
+        // Groups still open continue past the end of the scene
+        for(auto Group : DOpenGroups){
+            DScene.DGroups[Group].DRunEnd = DScene.DRuns.size();
+        }
+        DScene.DStyles.reserve(DStyles.Size());
+        for(std::size_t Index = 0; Index < DStyles.Size(); Index++){
+            DScene.DStyles.emplace_back(DStyles.Name(Index));
+        }
+    }
+};
+/**
+ * @brief Constructs a scene builder, clearing the scene.
+ * @param scene Reference to the scene to build, which must outlive the builder.
+ */
+CSVGSceneBuilder::CSVGSceneBuilder(SSVGScene &scene){
+    DImplementation = std::make_unique<SImplementation>(scene);
+}
+/**
+ * @brief Destructor for the scene builder.
+ */
+CSVGSceneBuilder::~CSVGSceneBuilder(){
+
+}
+/**
+ * @brief Appends an element to the scene.
+ *
+ * The first Document element sets the scene size. Group attributes are
+ * copied from entity, the other element types only use shape.
+ * @param shape Element read by CSVGReader::ReadElement().
+ * @param entity Entity the element was read from.
+ */
+void CSVGSceneBuilder::Add(const SSVGShape &shape, const SXMLEntityView &entity){
+    DImplementation->Add(shape, entity);
+}
+/**
+ * @brief Completes the scene by filling in its style table.
+ */
+void CSVGSceneBuilder::Finish(){
+    DImplementation->Finish();
+}
+
+struct CSVGSceneLoader::SImplementation{
+    std::size_t DChunkSize;
+    std::size_t DThreads;
+    bool DFastTokenizer;
+    std::size_t DSkippedShapes = 0;
+
+    SImplementation(std::size_t chunksize, std::size_t threads, bool fasttokenizer) : DChunkSize(chunksize), DThreads(threads), DFastTokenizer(fasttokenizer){
+
+    }
+
+    bool Load(std::shared_ptr< CDataSource > src, SSVGScene &scene){
+        CSVGReader Reader(src, DChunkSize, DThreads, DFastTokenizer);
+        CSVGSceneBuilder Builder(scene);
+        SSVGShape Shape;
+        bool FoundDocument = false;
+
+        while(Reader.ReadElement(Shape)){
+            FoundDocument |= Shape.DType == SSVGShape::EType::Document;
+            Builder.Add(Shape, Reader.Entity());
+        }
+        Builder.Finish();
+        DSkippedShapes = Reader.SkippedShapes();
+        return FoundDocument;
+    }
+};
+/**
+ * @brief Constructs an SVG scene loader.
+ * @param chunksize Number of bytes pulled from the source per parse step.
+ * @param threads Threads used to parse a memory-resident source.
+ * @param fasttokenizer Whether to use the fast tokenizer on a memory-resident source.
+ */
+CSVGSceneLoader::CSVGSceneLoader(std::size_t chunksize, std::size_t threads, bool fasttokenizer){
+    DImplementation = std::make_unique<SImplementation>(chunksize, threads, fasttokenizer);
+}
+/**
+ * @brief Destructor for the SVG scene loader.
+ */
+CSVGSceneLoader::~CSVGSceneLoader(){
+
+}
+/**
+ * @brief Loads the shapes of an SVG document into a scene.
+ *
+ * Any previous contents of the scene are discarded. Shapes with malformed
+ * geometry are skipped and counted by SkippedShapes().
+ * @param src Shared pointer to the data source to read SVG from.
+ * @param scene Reference to the scene to fill.
+ * @return True if the document had an svg element, false otherwise.
+ */
+bool CSVGSceneLoader::Load(std::shared_ptr< CDataSource > src, SSVGScene &scene){
+    return DImplementation->Load(src, scene);
+}
+/**
+ * @brief Gets the number of shapes skipped by the last load.
+ * @return Number of skipped shapes.
+ */
+std::size_t CSVGSceneLoader::SkippedShapes() const noexcept{
+    return DImplementation->DSkippedShapes;
+}
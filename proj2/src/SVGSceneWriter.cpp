@@ -0,0 +1,204 @@
+#include "SVGSceneWriter.h"
+#include "SVGWriter.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+struct CSVGSceneWriter::SImplementation{
+    // Scenes read but not yet written, and written scenes kept for reuse so
+    // their arrays are not reallocated for every batch
+    struct SQueue{
+        std::mutex DMutex;
+        std::condition_variable DReady;
+        std::condition_variable DSpace;
+        std::deque< std::unique_ptr<SSVGScene> > DPending;
+        std::vector< std::unique_ptr<SSVGScene> > DFree;
+        bool DDone = false;
+        bool DCancelled = false;
+    };
+
+    std::shared_ptr< CDataSink > DSink;
+    // Handle of every style string registered with the current writer,
+    // shared across the scenes it writes
+    std::unordered_map<std::string, SSVGStyleHandle> DStyleHandles;
+    std::vector<SSVGStyleHandle> DSceneStyles;
+
+    SImplementation(std::shared_ptr< CDataSink > sink) : DSink(sink){
+
+    }
+
+    static bool ValidSize(const SSVGSize &size){
+        return size.DWidth >= 1 && size.DHeight >= 1;
+    }
+
+    bool Emit(CSVGWriter &writer, const SSVGScene &scene){
+        DSceneStyles.clear();
+        for(auto &Style : scene.DStyles){
+            auto Search = DStyleHandles.find(Style);
+            if(Search == DStyleHandles.end()){
+                Search = DStyleHandles.emplace(Style, writer.RegisterStyleString(Style)).first;
+            }
+            DSceneStyles.push_back(Search->second);
+        }
+        for(auto &Run : scene.DRuns){
+            bool Success = true;
+            switch(Run.DType){
+                case SSVGShape::EType::Circle:      Success = writer.Circles(&scene.DCircles.DX[Run.DBegin], &scene.DCircles.DY[Run.DBegin], &scene.DCircles.DRadius[Run.DBegin], Run.DCount, DSceneStyles[Run.DStyle]);
+                                                    break;
+                case SSVGShape::EType::Rectangle:   Success = writer.Rectangles(&scene.DRectangles.DX[Run.DBegin], &scene.DRectangles.DY[Run.DBegin], &scene.DRectangles.DWidth[Run.DBegin], &scene.DRectangles.DHeight[Run.DBegin], Run.DCount, DSceneStyles[Run.DStyle]);
+                                                    break;
+                case SSVGShape::EType::Line:        Success = writer.Lines(&scene.DLines.DX1[Run.DBegin], &scene.DLines.DY1[Run.DBegin], &scene.DLines.DX2[Run.DBegin], &scene.DLines.DY2[Run.DBegin], Run.DCount, DSceneStyles[Run.DStyle]);
+                                                    break;
+                case SSVGShape::EType::GroupBegin:  Success = writer.GroupBegin(scene.DGroups[Run.DBegin].DAttributes);
+                                                    break;
+                case SSVGShape::EType::GroupEnd:    Success = writer.GroupEnd();
+                                                    break;
+                default:                            break;
+            }
+            if(!Success){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Write(const SSVGScene &scene){
+        if(!ValidSize(scene.DSize)){
+            return false;
+        }
+        CSVGWriter Writer(DSink, (TSVGPixel)scene.DSize.DWidth, (TSVGPixel)scene.DSize.DHeight);
+        DStyleHandles.clear();
+        return Emit(Writer, scene) && Writer.Flush();
+    }
+
+    // Hands a filled scene to the writer, waiting while the queue is full
+    static bool Push(SQueue &queue, std::unique_ptr<SSVGScene> &scene, std::size_t queuedepth){
+        std::unique_lock<std::mutex> Lock(queue.DMutex);
+        queue.DSpace.wait(Lock, [&]{
+            return queue.DCancelled || queue.DPending.size() < queuedepth;
+        });
+        if(queue.DCancelled){
+            return false;
+        }
+        queue.DPending.push_back(std::move(scene));
+        queue.DReady.notify_one();
+        return true;
+    }
+
+    static std::unique_ptr<SSVGScene> TakeFree(SQueue &queue){
+        std::lock_guard<std::mutex> Lock(queue.DMutex);
+        if(queue.DFree.empty()){
+            return std::make_unique<SSVGScene>();
+        }
+        auto Scene = std::move(queue.DFree.back());
+        queue.DFree.pop_back();
+        return Scene;
+    }
+
+    static void Read(SQueue &queue, std::shared_ptr< CDataSource > src, const TShapeFilter &filter, std::size_t batchsize, std::size_t queuedepth){
+        CSVGReader Reader(src);
+        SSVGShape Shape;
+        auto Scene = TakeFree(queue);
+        auto Builder = std::make_unique<CSVGSceneBuilder>(*Scene);
+        bool Running = true;
+        while(Running && Reader.ReadElement(Shape)){
+            bool IsShape = Shape.DType == SSVGShape::EType::Circle || Shape.DType == SSVGShape::EType::Rectangle || Shape.DType == SSVGShape::EType::Line;
+            if(IsShape && filter && !filter(Shape, Reader.Entity())){
+                continue;
+            }
+            Builder->Add(Shape, Reader.Entity());
+            if(Scene->DRuns.size() + Scene->ShapeCount() >= batchsize){
+                Builder->Finish();
+                Running = Push(queue, Scene, queuedepth);
+                Scene = TakeFree(queue);
+                Builder = std::make_unique<CSVGSceneBuilder>(*Scene);
+            }
+        }
+        if(Running){
+            Builder->Finish();
+            Push(queue, Scene, queuedepth);
+        }
+        std::lock_guard<std::mutex> Lock(queue.DMutex);
+        queue.DDone = true;
+        queue.DReady.notify_one();
+    }
+
+    bool Pipe(std::shared_ptr< CDataSource > src, const TShapeFilter &filter, std::size_t batchsize, std::size_t queuedepth){
+        SQueue Queue;
+        std::thread Reader(Read, std::ref(Queue), src, std::cref(filter), std::max<std::size_t>(batchsize, 1), std::max<std::size_t>(queuedepth, 1));
+        std::unique_ptr<CSVGWriter> Writer;
+        bool Success = true;
+        while(Success){
+            std::unique_ptr<SSVGScene> Scene;
+            {
+                std::unique_lock<std::mutex> Lock(Queue.DMutex);
+                Queue.DReady.wait(Lock, [&]{
+                    return Queue.DDone || !Queue.DPending.empty();
+                });
+                if(Queue.DPending.empty()){
+                    break;
+                }
+                Scene = std::move(Queue.DPending.front());
+                Queue.DPending.pop_front();
+                Queue.DSpace.notify_one();
+            }
+            // The svg element always comes first, so the first batch has the size
+            if(!Writer){
+                if(!ValidSize(Scene->DSize)){
+                    Success = false;
+                    break;
+                }
+                Writer = std::make_unique<CSVGWriter>(DSink, (TSVGPixel)Scene->DSize.DWidth, (TSVGPixel)Scene->DSize.DHeight);
+                DStyleHandles.clear();
+            }
+            Success = Emit(*Writer, *Scene);
+            std::lock_guard<std::mutex> Lock(Queue.DMutex);
+            Queue.DFree.push_back(std::move(Scene));
+        }
+        if(!Success){
+            std::lock_guard<std::mutex> Lock(Queue.DMutex);
+            Queue.DCancelled = true;
+            Queue.DSpace.notify_one();
+        }
+        Reader.join();
+        return Success && Writer && Writer->Flush();
+    }
+};
+/**
+ * @brief Constructs a scene writer.
+ * @param sink Shared pointer to the data sink documents are written to.
+ */
+CSVGSceneWriter::CSVGSceneWriter(std::shared_ptr< CDataSink > sink){
+    DImplementation = std::make_unique<SImplementation>(sink);
+}
+/**
+ * @brief Destructor for the scene writer.
+ */
+CSVGSceneWriter::~CSVGSceneWriter(){
+
+}
+/**
+ * @brief Writes a scene to the sink as a complete SVG document.
+ * @param scene Scene to write; its size must be at least one pixel each way.
+ * @return True on success, false if the size is invalid or a write failed.
+ */
+bool CSVGSceneWriter::Write(const SSVGScene &scene){
+    return DImplementation->Write(scene);
+}
+/**
+ * @brief Streams the shapes of an SVG document to the sink.
+ *
+ * The source is read on a separate thread into scenes of about batchsize
+ * entries that are written as they arrive, so reading overlaps writing.
+ * At most queuedepth read scenes wait to be written before reading blocks.
+ * @param src Shared pointer to the data source to read SVG from.
+ * @param filter Optional filter applied to every shape before it is queued.
+ * @param batchsize Shapes and runs per queued scene.
+ * @param queuedepth Maximum number of queued scenes.
+ * @return True on success, false if the document has no valid size or a write failed.
+ */
+bool CSVGSceneWriter::Pipe(std::shared_ptr< CDataSource > src, TShapeFilter filter, std::size_t batchsize, std::size_t queuedepth){
+    return DImplementation->Pipe(src, filter, batchsize, queuedepth);
+}
@@ -1,60 +1,271 @@
 #include "SVGWriter.h"
 #include "svg.h"
+#include "svg_number.h"
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <iostream>
 
+// Path points are handed to svg_path() without copying
+static_assert(sizeof(SSVGPoint) == sizeof(svg_point_t) && offsetof(SSVGPoint, DX) == offsetof(svg_point_t, x) && offsetof(SSVGPoint, DY) == offsetof(svg_point_t, y), "SSVGPoint must match svg_point_t");
+static_assert(SSVGPathOptions::ShortestPrecision == SVG_PRECISION_SHORTEST, "Path precisions must match svg_number.h");
+
 struct CSVGWriter::SImplementation {
+    struct SStyleEntry{
+        std::size_t DHash;
+        TAttributes DStyle;
+        std::string DString;
+    };
+
     std::shared_ptr< CDataSink > DSink;
     svg_context_ptr DContext;
+    // Most recently used first; the index maps attribute hashes to entries
+    std::list<SStyleEntry> DStyleEntries;
+    std::unordered_multimap<std::size_t, std::list<SStyleEntry>::iterator> DStyleIndex;
+    std::size_t DStyleCacheSize;
+    std::size_t DStyleHits = 0;
+    std::size_t DStyleMisses = 0;
+    std::vector<std::string> DRegisteredStyles;
+    std::string DUncachedStyle;
 
     static svg_return_t WriteFunction(svg_user_context_ptr user, const char *text) {
         SImplementation *Implementation = (SImplementation *)user;
-        while(*text) {
-        Implementation->DSink->Put(*text++);
+        if(!Implementation->DSink->Write(text, std::strlen(text))){
+            return SVG_ERR_IO;
         }
         return SVG_OK;
     }
 
-    SImplementation(std::shared_ptr< CDataSink > sink, TSVGPixel width, TSVGPixel height) : DSink(sink) {
-    DContext = svg_create(WriteFunction, nullptr, this, width, height);
+    static svg_return_t CleanupFunction(svg_user_context_ptr user) {
+        return SVG_OK;
+    }
+
+    SImplementation(std::shared_ptr< CDataSink > sink, TSVGPixel width, TSVGPixel height, std::size_t stylecachesize) : DSink(sink), DStyleCacheSize(stylecachesize) {
+    DContext = svg_create(WriteFunction, CleanupFunction, this, width, height);
     }
 
-    ~SImplementation(){}
+    ~SImplementation(){
+        svg_destroy(DContext);
+    }
+
+    // Appends text escaped for use inside a double quoted attribute value
+    static void AppendEscaped(std::string &result, const std::string &text){
+        for(char Char : text){
+            switch(Char){
+                case '&':   result += "&amp;";
+                            break;
+                case '<':   result += "&lt;";
+                            break;
+                case '"':   result += "&quot;";
+                            break;
+                default:    result += Char;
+                            break;
+            }
+        }
+    }
 
     std::string CreateStyleString(const TAttributes &style){
-        return " ";
+        std::string Result;
+        for(auto &Attribute : style){
+            if(!Result.empty()){
+                Result += ";";
+            }
+            AppendEscaped(Result, std::get<0>(Attribute));
+            Result += ":";
+            AppendEscaped(Result, std::get<1>(Attribute));
+        }
+        return Result;
+    }
+
+    std::string CreateAttributeString(const TAttributes &attrs){
+        std::string Result;
+        for(auto &Attribute : attrs){
+            if(!Result.empty()){
+                Result += " ";
+            }
+            Result += std::get<0>(Attribute) + "=\"";
+            AppendEscaped(Result, std::get<1>(Attribute));
+            Result += "\"";
+        }
+        return Result;
     }
         
-    bool Circle(const SSVGPoint &center, TSVGReal radius, const TAttributes &style){
+    // FNV-1a over the names and values, with separators so that moving
+    // characters between fields changes the hash
+    static std::size_t HashStyle(const TAttributes &style){
+        std::uint64_t Hash = 14695981039346656037ULL;
+        auto Mix = [&Hash](const std::string &text){
+            for(unsigned char Char : text){
+                Hash = (Hash ^ Char) * 1099511628211ULL;
+            }
+            Hash = (Hash ^ 0xFF) * 1099511628211ULL;
+        };
+        for(auto &Attribute : style){
+            Mix(std::get<0>(Attribute));
+            Mix(std::get<1>(Attribute));
+        }
+        return (std::size_t)Hash;
+    }
+
+    // Serialised form of style, from the cache when it has been seen recently
+    const std::string &StyleString(const TAttributes &style){
+        if(!DStyleCacheSize){
+            DStyleMisses++;
+            DUncachedStyle = CreateStyleString(style);
+            return DUncachedStyle;
+        }
+        std::size_t Hash = HashStyle(style);
+        auto Range = DStyleIndex.equal_range(Hash);
+        for(auto Search = Range.first; Search != Range.second; ++Search){
+            if(Search->second->DStyle == style){
+                DStyleHits++;
+                DStyleEntries.splice(DStyleEntries.begin(), DStyleEntries, Search->second);
+                return Search->second->DString;
+            }
+        }
+        DStyleMisses++;
+        if(DStyleEntries.size() >= DStyleCacheSize){
+            auto Oldest = std::prev(DStyleEntries.end());
+            auto OldRange = DStyleIndex.equal_range(Oldest->DHash);
+            for(auto Search = OldRange.first; Search != OldRange.second; ++Search){
+                if(Search->second == Oldest){
+                    DStyleIndex.erase(Search);
+                    break;
+                }
+            }
+            DStyleEntries.erase(Oldest);
+        }
+        DStyleEntries.push_front({Hash, style, CreateStyleString(style)});
+        DStyleIndex.emplace(Hash, DStyleEntries.begin());
+        return DStyleEntries.front().DString;
+    }
+
+    SSVGStyleHandle RegisterStyle(const TAttributes &style){
+        DRegisteredStyles.push_back(CreateStyleString(style));
+        return SSVGStyleHandle((std::uint32_t)DRegisteredStyles.size() - 1);
+    }
+
+    SSVGStyleHandle RegisterStyleString(const std::string &style){
+        std::string Result;
+        AppendEscaped(Result, style);
+        DRegisteredStyles.push_back(std::move(Result));
+        return SSVGStyleHandle((std::uint32_t)DRegisteredStyles.size() - 1);
+    }
+
+    // Serialised form of a registered style, or nullptr for a foreign handle
+    const char *StyleString(SSVGStyleHandle style) const{
+        return style.DIndex < DRegisteredStyles.size() ? DRegisteredStyles[style.DIndex].c_str() : nullptr;
+    }
+
+    bool Circle(const SSVGPoint &center, TSVGReal radius, const char *style){
         svg_point_t Center{center.DX, center.DY};
-        std::string Style = CreateStyleString(style);
-        return svg_circle(DContext, &Center, radius, Style.c_str{}); 
-        return false;
+        return style && svg_circle(DContext, &Center, radius, style) == SVG_OK; 
     }
     
-    bool Rectangle(const SSVGPoint &topleft, const SSVGSize &size, const TAttributes &style){
-        return false;
+    bool Rectangle(const SSVGPoint &topleft, const SSVGSize &size, const char *style){
+        svg_point_t TopLeft{topleft.DX, topleft.DY};
+        svg_size_t Size{size.DWidth, size.DHeight};
+        return style && svg_rect(DContext, &TopLeft, &Size, style) == SVG_OK;
     }
-    bool Line(const SSVGPoint &start, const SSVGPoint &end, const TAttributes &style){
-        return false;
+
+    bool Line(const SSVGPoint &start, const SSVGPoint &end, const char *style){
+        svg_point_t Start{start.DX, start.DY};
+        svg_point_t End{end.DX, end.DY};
+        return style && svg_line(DContext, &Start, &End, style) == SVG_OK;
+    }
+
+    bool Circles(const TSVGCoordinate *cx, const TSVGCoordinate *cy, const TSVGReal *radius, std::size_t count, const char *style){
+        return style && svg_circles(DContext, cx, cy, radius, count, style) == SVG_OK;
+    }
+
+    bool Rectangles(const TSVGCoordinate *x, const TSVGCoordinate *y, const TSVGReal *width, const TSVGReal *height, std::size_t count, const char *style){
+        return style && svg_rects(DContext, x, y, width, height, count, style) == SVG_OK;
+    }
+
+    bool Lines(const TSVGCoordinate *x1, const TSVGCoordinate *y1, const TSVGCoordinate *x2, const TSVGCoordinate *y2, std::size_t count, const char *style){
+        return style && svg_lines(DContext, x1, y1, x2, y2, count, style) == SVG_OK;
+    }
+    
+    bool Path(const SSVGPoint *points, std::size_t count, const SSVGPathOptions &options, const char *style){
+        svg_path_options_t Options{options.DRelative, options.DTolerance, options.DPrecision};
+        return style && svg_path(DContext, reinterpret_cast<const svg_point_t *>(points), count, &Options, style) == SVG_OK;
     }
     
-    bool SimplePath(const std::vector<SSVGPoint> points, const TAttributes &style) {
+    // Segments of a SimplePath waiting to be written with one svg_lines call
+    struct SSegmentBlock{
+        static constexpr std::size_t Capacity = 64;
+        svg_context_ptr DContext;
+        const char *DStyle;
+        TSVGCoordinate DX1[Capacity], DY1[Capacity], DX2[Capacity], DY2[Capacity];
+        std::size_t DCount = 0;
+        svg_point_t DPrevious;
+        bool DHasPrevious = false;
+
+        svg_return_t Flush(){
+            svg_return_t Result = svg_lines(DContext, DX1, DY1, DX2, DY2, DCount, DStyle);
+            DCount = 0;
+            return Result;
+        }
+    };
+
+    static svg_return_t SegmentPoint(svg_user_context_ptr user, const svg_point_t *point){
+        SSegmentBlock *Block = (SSegmentBlock *)user;
+        if(Block->DHasPrevious){
+            Block->DX1[Block->DCount] = Block->DPrevious.x;
+            Block->DY1[Block->DCount] = Block->DPrevious.y;
+            Block->DX2[Block->DCount] = point->x;
+            Block->DY2[Block->DCount] = point->y;
+            if(++Block->DCount == SSegmentBlock::Capacity){
+                svg_return_t Result = Block->Flush();
+                if(Result != SVG_OK){
+                    return Result;
+                }
+            }
+        }
+        Block->DPrevious = *point;
+        Block->DHasPrevious = true;
+        return SVG_OK;
+    }
+
+    bool SimplePath(const std::vector<SSVGPoint> &points, const TAttributes &style) {
+        if(points.size() < 2){
+            return false;
+        }
+        SSegmentBlock Block;
+        Block.DContext = DContext;
+        Block.DStyle = StyleString(style).c_str();
+        return svg_decimate(DContext, reinterpret_cast<const svg_point_t *>(points.data()), points.size(), SegmentPoint, &Block) == SVG_OK && Block.Flush() == SVG_OK;
+    }
+
+    bool SetDecimation(EDecimation mode){
+        switch(mode){
+            case EDecimation::None:     return svg_set_decimation(DContext, SVG_DECIMATE_NONE) == SVG_OK;
+            case EDecimation::MinMax:   return svg_set_decimation(DContext, SVG_DECIMATE_MINMAX) == SVG_OK;
+            case EDecimation::LTTB:     return svg_set_decimation(DContext, SVG_DECIMATE_LTTB) == SVG_OK;
+        }
         return false;
     }
     
     bool GroupBegin(const TAttributes &attrs) {
-        return false;
+        std::string Attributes = CreateAttributeString(attrs);
+        return svg_group_begin(DContext, Attributes.c_str()) == SVG_OK;
     }
 
     bool GroupEnd() {
-        return false;
+        return svg_group_end(DContext) == SVG_OK;
     } 
+
+    bool Flush() {
+        return svg_flush(DContext) == SVG_OK;
+    }
 };
 
-CSVGWriter::CSVGWriter(std::shared_ptr< CDataSink > sink, TSVGPixel width, TSVGPixel height) {
-    DImplementation = std::make_unique<SImplementation>();
+CSVGWriter::CSVGWriter(std::shared_ptr< CDataSink > sink, TSVGPixel width, TSVGPixel height, std::size_t stylecachesize) {
+    DImplementation = std::make_unique<SImplementation>(sink, width, height, stylecachesize);
 }
 
 CSVGWriter::~CSVGWriter() {
@@ -62,26 +273,90 @@ CSVGWriter::~CSVGWriter() {
 }
 
 bool CSVGWriter::Circle(const SSVGPoint &center, TSVGReal radius, const TAttributes &style) {
-    return DImplementation->Circle(center, radius, style);
+    return DImplementation->Circle(center, radius, DImplementation->StyleString(style).c_str());
 }
 
-bool CSVGWriter::Rectangle(const SSVGPoint &topleft, const SSVGSize &size, const TAttributes &style) {
-     return DImplementation->Rectangle(topleft, size, style);
+bool CSVGWriter::Rectange(const SSVGPoint &topleft, const SSVGSize &size, const TAttributes &style) {
+     return DImplementation->Rectangle(topleft, size, DImplementation->StyleString(style).c_str());
 }
 
 bool CSVGWriter::Line(const SSVGPoint &start, const SSVGPoint &end, const TAttributes &style) {
-    return DImplementation->Line(start, end, style);
+    return DImplementation->Line(start, end, DImplementation->StyleString(style).c_str());
 }
 
-bool CSVGWriter::SimplePath(const std::vector<SSVGPoint> points, const TAttributes &style) {
+bool CSVGWriter::SimplePath(const std::vector<SSVGPoint> &points, const TAttributes &style) {
     return DImplementation->SimplePath(points, style);
 
 }
 
+bool CSVGWriter::Path(const SSVGPoint *points, std::size_t count, const SSVGPathOptions &options, const TAttributes &style) {
+    return DImplementation->Path(points, count, options, DImplementation->StyleString(style).c_str());
+}
+
+bool CSVGWriter::Circles(const TSVGCoordinate *cx, const TSVGCoordinate *cy, const TSVGReal *radius, std::size_t count, const TAttributes &style) {
+    return DImplementation->Circles(cx, cy, radius, count, DImplementation->StyleString(style).c_str());
+}
+
+bool CSVGWriter::Rectangles(const TSVGCoordinate *x, const TSVGCoordinate *y, const TSVGReal *width, const TSVGReal *height, std::size_t count, const TAttributes &style) {
+    return DImplementation->Rectangles(x, y, width, height, count, DImplementation->StyleString(style).c_str());
+}
+
+bool CSVGWriter::Lines(const TSVGCoordinate *x1, const TSVGCoordinate *y1, const TSVGCoordinate *x2, const TSVGCoordinate *y2, std::size_t count, const TAttributes &style) {
+    return DImplementation->Lines(x1, y1, x2, y2, count, DImplementation->StyleString(style).c_str());
+}
+
+SSVGStyleHandle CSVGWriter::RegisterStyle(const TAttributes &style) {
+    return DImplementation->RegisterStyle(style);
+}
+
+SSVGStyleHandle CSVGWriter::RegisterStyleString(const std::string &style) {
+    return DImplementation->RegisterStyleString(style);
+}
+
+bool CSVGWriter::Circle(const SSVGPoint &center, TSVGReal radius, SSVGStyleHandle style) {
+    return DImplementation->Circle(center, radius, DImplementation->StyleString(style));
+}
+
+bool CSVGWriter::Rectange(const SSVGPoint &topleft, const SSVGSize &size, SSVGStyleHandle style) {
+    return DImplementation->Rectangle(topleft, size, DImplementation->StyleString(style));
+}
+
+bool CSVGWriter::Line(const SSVGPoint &start, const SSVGPoint &end, SSVGStyleHandle style) {
+    return DImplementation->Line(start, end, DImplementation->StyleString(style));
+}
+
+bool CSVGWriter::Circles(const TSVGCoordinate *cx, const TSVGCoordinate *cy, const TSVGReal *radius, std::size_t count, SSVGStyleHandle style) {
+    return DImplementation->Circles(cx, cy, radius, count, DImplementation->StyleString(style));
+}
+
+bool CSVGWriter::Rectangles(const TSVGCoordinate *x, const TSVGCoordinate *y, const TSVGReal *width, const TSVGReal *height, std::size_t count, SSVGStyleHandle style) {
+    return DImplementation->Rectangles(x, y, width, height, count, DImplementation->StyleString(style));
+}
+
+bool CSVGWriter::Lines(const TSVGCoordinate *x1, const TSVGCoordinate *y1, const TSVGCoordinate *x2, const TSVGCoordinate *y2, std::size_t count, SSVGStyleHandle style) {
+    return DImplementation->Lines(x1, y1, x2, y2, count, DImplementation->StyleString(style));
+}
+
+bool CSVGWriter::Path(const SSVGPoint *points, std::size_t count, const SSVGPathOptions &options, SSVGStyleHandle style) {
+    return DImplementation->Path(points, count, options, DImplementation->StyleString(style));
+}
+
+bool CSVGWriter::SetDecimation(EDecimation mode) {
+    return DImplementation->SetDecimation(mode);
+}
+
+CSVGWriter::SStyleCacheStats CSVGWriter::StyleCacheStats() const noexcept {
+    return {DImplementation->DStyleEntries.size(), DImplementation->DStyleHits, DImplementation->DStyleMisses};
+}
+
 bool CSVGWriter::GroupBegin(const TAttributes &attrs) {
     return DImplementation->GroupBegin(attrs);
 }
 
 bool CSVGWriter::GroupEnd() {
     return DImplementation->GroupEnd();
-}
\ No newline at end of file
+}
+
+bool CSVGWriter::Flush() {
+    return DImplementation->Flush();
+}
@@ -1,15 +1,58 @@
 #include "StringDataSink.h"
+#include <algorithm>
+
+CStringDataSink::CStringDataSink(std::size_t capacity) : DReallocationCount(0){
+    DString.reserve(capacity);
+    DPeakCapacity = DString.capacity();
+}
+
+// Grows the string geometrically itself so that reallocations can be counted
+bool CStringDataSink::Append(const char *buf, std::size_t length) noexcept{
+    std::size_t Required = DString.size() + length;
+    if(Required > DString.capacity()){
+        try{
+            DString.reserve(std::max(Required, DString.capacity() * 2));
+        }
+        catch(...){
+            return false;
+        }
+        DReallocationCount++;
+        DPeakCapacity = std::max(DPeakCapacity, DString.capacity());
+    }
+    DString.append(buf,length);
+    return true;
+}
 
 const std::string &CStringDataSink::String() const{
     return DString;
 }
 
+std::string_view CStringDataSink::StringView() const noexcept{
+    return DString;
+}
+
+std::string CStringDataSink::TakeString() noexcept{
+    std::string Result = std::move(DString);
+    DString.clear();
+    return Result;
+}
+
+std::size_t CStringDataSink::ReallocationCount() const noexcept{
+    return DReallocationCount;
+}
+
+std::size_t CStringDataSink::PeakCapacity() const noexcept{
+    return DPeakCapacity;
+}
+
 bool CStringDataSink::Put(const char &ch) noexcept{
-    DString += std::string(1,ch);
-    return true;
+    return Append(&ch,1);
 }
 
 bool CStringDataSink::Write(const std::vector<char> &buf) noexcept{
-    DString += std::string(buf.data(),buf.size());
-    return true;
+    return Append(buf.data(),buf.size());
+}
+
+bool CStringDataSink::Write(const char *buf, std::size_t length) noexcept{
+    return Append(buf,length);
 }
@@ -1,4 +1,6 @@
 #include "StringDataSource.h"
+#include <algorithm>
+#include <cstring>
 
 CStringDataSource::CStringDataSource(const std::string &str) : DString(str), DIndex(0){
 
@@ -26,15 +28,28 @@ bool CStringDataSource::Peek(char &ch) noexcept{
 }
 
 bool CStringDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
-    buf.clear();
-    while(buf.size() < count){
-        char TempChar;
-        if(Get(TempChar)){
-            buf.push_back(TempChar);
-        }
-        else{
-            break;
-        }
+    count = std::min(count, DString.length() - std::min(DIndex, DString.length()));
+    try{
+        buf.resize(count);
     }
+    catch(...){
+        buf.clear();
+        return false;
+    }
+    buf.resize(Read(buf.data(), count));
     return !buf.empty();
 }
+
+std::size_t CStringDataSource::Read(char *buf, std::size_t capacity) noexcept{
+    if(DIndex >= DString.length()){
+        return 0;
+    }
+    std::size_t Count = std::min(capacity, DString.length() - DIndex);
+    std::memcpy(buf, DString.data() + DIndex, Count);
+    DIndex += Count;
+    return Count;
+}
+
+std::string_view CStringDataSource::Contents() const noexcept{
+    return std::string_view(DString).substr(std::min(DIndex, DString.length()));
+}
@@ -0,0 +1,162 @@
+#include "XMLBatchReader.h"
+#include "MMapDataSource.h"
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct CXMLBatchReader::SImplementation{
+    // Pending document indices of one worker; the owner takes from the front
+    // and thieves take from the back so they rarely contend
+    struct SWorkQueue{
+        std::mutex DMutex;
+        std::deque<std::size_t> DDocuments;
+    };
+
+    std::size_t DThreadCount;
+    std::size_t DChunkSize;
+
+    SImplementation(std::size_t threads, std::size_t chunksize) : DChunkSize(chunksize){
+        DThreadCount = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    static bool PopFront(SWorkQueue &queue, std::size_t &document){
+        std::lock_guard<std::mutex> Lock(queue.DMutex);
+        if(queue.DDocuments.empty()){
+            return false;
+        }
+        document = queue.DDocuments.front();
+        queue.DDocuments.pop_front();
+        return true;
+    }
+
+    static bool PopBack(SWorkQueue &queue, std::size_t &document){
+        std::lock_guard<std::mutex> Lock(queue.DMutex);
+        if(queue.DDocuments.empty()){
+            return false;
+        }
+        document = queue.DDocuments.back();
+        queue.DDocuments.pop_back();
+        return true;
+    }
+
+    void Worker(std::size_t id, std::vector<SWorkQueue> &queues, const std::vector< std::shared_ptr< CDataSource > > &sources, const TEntityCallback &callback, bool skipcdata){
+        std::unique_ptr<CXMLReader> Reader;
+        SXMLEntityView Entity;
+        std::size_t Document;
+        while(true){
+            bool Found = PopFront(queues[id], Document);
+            // No new work is ever queued, so once every queue has been seen
+            // empty the batch is done
+            for(std::size_t Offset = 1; !Found && Offset < queues.size(); Offset++){
+                Found = PopBack(queues[(id + Offset) % queues.size()], Document);
+            }
+            if(!Found){
+                return;
+            }
+            if(Reader){
+                Reader->Reset(sources[Document]);
+            }
+            else{
+                Reader = std::make_unique<CXMLReader>(sources[Document], DChunkSize);
+            }
+            while(Reader->ReadEntityView(Entity, skipcdata)){
+                callback(Document, Entity);
+            }
+        }
+    }
+
+    void Ingest(const std::vector< std::shared_ptr< CDataSource > > &sources, const TEntityCallback &callback, bool skipcdata){
+        std::size_t ThreadCount = std::min(DThreadCount, sources.size());
+        if(!ThreadCount){
+            return;
+        }
+        // Contiguous blocks keep each worker on neighbouring documents until
+        // it runs dry and starts stealing
+        std::vector<SWorkQueue> Queues(ThreadCount);
+        for(std::size_t Index = 0; Index < sources.size(); Index++){
+            Queues[Index * ThreadCount / sources.size()].DDocuments.push_back(Index);
+        }
+        std::vector<std::thread> Threads;
+        for(std::size_t Index = 1; Index < ThreadCount; Index++){
+            Threads.emplace_back(&SImplementation::Worker, this, Index, std::ref(Queues), std::cref(sources), std::cref(callback), skipcdata);
+        }
+        Worker(0, Queues, sources, callback, skipcdata);
+        for(auto &Thread : Threads){
+            Thread.join();
+        }
+    }
+};
+/**
+ * @brief Constructs a batch reader.
+ * @param threads Number of worker threads, 0 for one per hardware thread.
+ * @param chunksize Number of bytes each reader pulls from a source per parse step.
+ */
+CXMLBatchReader::CXMLBatchReader(std::size_t threads, std::size_t chunksize){
+    DImplementation = std::make_unique<SImplementation>(threads, chunksize);
+}
+/**
+ * @brief Destructor for the batch reader.
+ */
+CXMLBatchReader::~CXMLBatchReader(){
+
+}
+/**
+ * @brief Gets the number of worker threads used per batch.
+ * @return Worker thread count.
+ */
+std::size_t CXMLBatchReader::ThreadCount() const noexcept{
+    return DImplementation->DThreadCount;
+}
+/**
+ * @brief Parses a batch of documents, passing every entity to a callback.
+ *
+ * Returns once all documents have been parsed. The callback runs on the
+ * worker threads, possibly concurrently for different documents, and the
+ * entity views are only valid during the call.
+ * @param sources Data sources of the documents; each must be used by one batch only.
+ * @param callback Function called with the document index and each entity.
+ * @param skipcdata Whether to skip character data.
+ */
+void CXMLBatchReader::Ingest(const std::vector< std::shared_ptr< CDataSource > > &sources, TEntityCallback callback, bool skipcdata){
+    DImplementation->Ingest(sources, callback, skipcdata);
+}
+/**
+ * @brief Parses a batch of files, passing every entity to a callback.
+ * @param paths Paths of the documents; each is memory mapped for parsing.
+ * @param callback Function called with the index into paths and each entity.
+ * @param skipcdata Whether to skip character data.
+ * @return False without parsing anything if any file could not be opened.
+ */
+bool CXMLBatchReader::IngestFiles(const std::vector< std::string > &paths, TEntityCallback callback, bool skipcdata){
+    std::vector< std::shared_ptr< CDataSource > > Sources;
+    for(auto &Path : paths){
+        auto Source = std::make_shared<CMMapDataSource>(Path);
+        if(!Source->Valid()){
+            return false;
+        }
+        Sources.push_back(Source);
+    }
+    DImplementation->Ingest(Sources, callback, skipcdata);
+    return true;
+}
+/**
+ * @brief Parses a batch of documents into owning entities.
+ * @param sources Data sources of the documents.
+ * @param skipcdata Whether to skip character data.
+ * @return One vector per source holding its entities in document order.
+ */
+std::vector< std::vector< SXMLEntity > > CXMLBatchReader::Ingest(const std::vector< std::shared_ptr< CDataSource > > &sources, bool skipcdata){
+    std::vector< std::vector< SXMLEntity > > Results(sources.size());
+    // Each document is handled by one worker, so its vector is never shared
+    DImplementation->Ingest(sources, [&Results](std::size_t document, const SXMLEntityView &entity){
+        SXMLEntity &Entity = Results[document].emplace_back();
+        Entity.DType = entity.DType;
+        Entity.DNameData.assign(entity.DNameData);
+        Entity.DAttributes.reserve(entity.DAttributes.size());
+        for(auto &Attribute : entity.DAttributes){
+            Entity.DAttributes.emplace_back(std::string(std::get<0>(Attribute)), std::string(std::get<1>(Attribute)));
+        }
+    }, skipcdata);
+    return Results;
+}
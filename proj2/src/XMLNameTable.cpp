@@ -0,0 +1,57 @@
+#include "XMLNameTable.h"
+
+// Element and attribute names that make up nearly all of a typical SVG
+static const char *SVGVocabulary[] = {
+    "svg", "g", "defs", "use", "symbol", "title", "desc", "style",
+    "circle", "ellipse", "rect", "line", "polyline", "polygon", "path",
+    "text", "tspan", "image", "linearGradient", "radialGradient", "stop",
+    "clipPath", "mask", "pattern", "marker",
+    "xmlns", "xmlns:xlink", "xlink:href", "href", "version", "id", "class",
+    "width", "height", "viewBox", "preserveAspectRatio", "transform",
+    "x", "y", "cx", "cy", "r", "rx", "ry", "x1", "y1", "x2", "y2",
+    "d", "points", "dx", "dy", "offset",
+    "fill", "fill-opacity", "fill-rule", "stroke", "stroke-width",
+    "stroke-opacity", "stroke-linecap", "stroke-linejoin", "stroke-dasharray",
+    "opacity", "font-family", "font-size", "font-weight", "text-anchor",
+    "stop-color", "stop-opacity", "gradientUnits", "clip-path"
+};
+
+CXMLNameTable::CXMLNameTable(bool preloadsvg) : DLookups(0), DHits(0){
+    if(preloadsvg){
+        for(auto Name : SVGVocabulary){
+            Intern(Name);
+        }
+        DLookups = DHits = 0;
+    }
+}
+
+TXMLNameID CXMLNameTable::Intern(std::string_view name){
+    DLookups++;
+    auto Search = DIndex.find(name);
+    if(Search != DIndex.end()){
+        DHits++;
+        return Search->second;
+    }
+    // Deque elements never move, so the views used as keys stay valid
+    TXMLNameID NewID = (TXMLNameID)DNames.size();
+    DNames.emplace_back(name);
+    DIndex.emplace(DNames.back(), NewID);
+    return NewID;
+}
+
+TXMLNameID CXMLNameTable::Find(std::string_view name) const noexcept{
+    auto Search = DIndex.find(name);
+    return Search == DIndex.end() ? InvalidXMLNameID : Search->second;
+}
+
+std::string_view CXMLNameTable::Name(TXMLNameID id) const noexcept{
+    return id < DNames.size() ? std::string_view(DNames[id]) : std::string_view();
+}
+
+std::size_t CXMLNameTable::Size() const noexcept{
+    return DNames.size();
+}
+
+CXMLNameTable::SStats CXMLNameTable::Stats() const noexcept{
+    return {DNames.size(), DLookups, DHits};
+}
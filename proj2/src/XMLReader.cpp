@@ -1,53 +1,1120 @@
 #include "XMLReader.h"
+#include "XMLNameTable.h"
 #include <expat.h>
-#include <queue>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define XMLREADER_AVX2_DISPATCH
+#endif
+
+// Index of the first byte of data equal to a, b or c, or that is below 0x20
+// or above 0x7F, or length if there is none. The fast tokenizer uses the
+// second group to catch whitespace that needs care and anything non-ASCII.
+static std::size_t FindSpecialScalar(const char *data, std::size_t length, char a, char b, char c, std::size_t index){
+    for(; index < length; index++){
+        signed char Ch = data[index];
+        if(Ch == a || Ch == b || Ch == c || Ch < 0x20){
+            return index;
+        }
+    }
+    return length;
+}
+
+#ifdef __SSE2__
+static std::size_t FindSpecialSSE2(const char *data, std::size_t length, char a, char b, char c){
+    const __m128i A = _mm_set1_epi8(a);
+    const __m128i B = _mm_set1_epi8(b);
+    const __m128i C = _mm_set1_epi8(c);
+    // Signed compare, so bytes above 0x7F count as below 0x20
+    const __m128i Limit = _mm_set1_epi8(0x20);
+    std::size_t Index = 0;
+    for(; Index + 16 <= length; Index += 16){
+        __m128i Block = _mm_loadu_si128((const __m128i *)(data + Index));
+        __m128i Match = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Block, A), _mm_cmpeq_epi8(Block, B)), _mm_or_si128(_mm_cmpeq_epi8(Block, C), _mm_cmplt_epi8(Block, Limit)));
+        int Mask = _mm_movemask_epi8(Match);
+        if(Mask){
+            return Index + __builtin_ctz(Mask);
+        }
+    }
+    return FindSpecialScalar(data, length, a, b, c, Index);
+}
+#endif
+
+#ifdef XMLREADER_AVX2_DISPATCH
+__attribute__((target("avx2"))) static std::size_t FindSpecialAVX2(const char *data, std::size_t length, char a, char b, char c){
+    const __m256i A = _mm256_set1_epi8(a);
+    const __m256i B = _mm256_set1_epi8(b);
+    const __m256i C = _mm256_set1_epi8(c);
+    const __m256i Limit = _mm256_set1_epi8(0x20);
+    std::size_t Index = 0;
+    for(; Index + 32 <= length; Index += 32){
+        __m256i Block = _mm256_loadu_si256((const __m256i *)(data + Index));
+        __m256i Match = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(Block, A), _mm256_cmpeq_epi8(Block, B)), _mm256_or_si256(_mm256_cmpeq_epi8(Block, C), _mm256_cmpgt_epi8(Limit, Block)));
+        unsigned Mask = _mm256_movemask_epi8(Match);
+        if(Mask){
+            return Index + __builtin_ctz(Mask);
+        }
+    }
+    return FindSpecialScalar(data, length, a, b, c, Index);
+}
+#endif
+
+static std::size_t FindSpecialDefault(const char *data, std::size_t length, char a, char b, char c){
+#ifdef __SSE2__
+    return FindSpecialSSE2(data, length, a, b, c);
+#else
+    return FindSpecialScalar(data, length, a, b, c, 0);
+#endif
+}
+
+using TFindSpecial = std::size_t (*)(const char *, std::size_t, char, char, char);
+
+static TFindSpecial ChooseFindSpecial(){
+#ifdef XMLREADER_AVX2_DISPATCH
+    if(__builtin_cpu_supports("avx2")){
+        return FindSpecialAVX2;
+    }
+#endif
+    return FindSpecialDefault;
+}
+
+static const TFindSpecial FindSpecial = ChooseFindSpecial();
 
 struct CXMLReader::SImplementation{
+    // Parsed entities are stored as offsets into an arena so that a whole
+    // chunk of events costs no per-entity allocations once buffers have grown
+    struct SStringRecord{
+        std::size_t DOffset;
+        std::size_t DLength;
+    };
+
+    // Names are interned rather than copied into the arena
+    struct SAttributeRecord{
+        TXMLNameID DName;
+        SStringRecord DValue;
+    };
+
+    struct SEventRecord{
+        SXMLEntity::EType DType;
+        TXMLNameID DNameID;
+        SStringRecord DNameData;
+        std::size_t DAttributeBegin;
+        std::size_t DAttributeCount;
+        // Position of the entity in the bytes fed to the parser
+        std::size_t DOffset;
+    };
+
+    // An expat parser together with the events it has produced so far
+    struct SEventParser{
+        XML_Parser DParser;
+        CXMLNameTable &DNames;
+        std::vector<SEventRecord> DEvents;
+        std::vector<SAttributeRecord> DAttributes;
+        std::vector<char> DArena;
+        std::string DCharData;
+        std::size_t DCharDataOffset = 0;
+        std::size_t DMaxCharData;
+        bool DSkipCData = false;
+
+        SEventParser(CXMLNameTable &names, std::size_t maxchardata) : DNames(names), DMaxCharData(maxchardata){
+            DParser = XML_ParserCreate(nullptr);
+            SetHandlers();
+        }
+
+        ~SEventParser(){
+            XML_ParserFree(DParser);
+        }
+
+        void SetHandlers(){
+            XML_SetUserData(DParser, this);
+            XML_SetElementHandler(DParser, StartElementHandler, EndElementHandler);
+            XML_SetCharacterDataHandler(DParser, CharacterDataHandler);
+        }
+
+        // Drops the events, keeping the capacity of their buffers
+        void Clear(){
+            DEvents.clear();
+            DAttributes.clear();
+            DArena.clear();
+        }
+
+        // Readies the parser for a new document
+        void Reset(){
+            XML_ParserReset(DParser, nullptr);
+            SetHandlers();
+            Clear();
+            DCharData.clear();
+        }
+
+        SStringRecord Store(const char *str, std::size_t length){
+            SStringRecord Record{DArena.size(), length};
+            DArena.insert(DArena.end(), str, str + length);
+            return Record;
+        }
+
+        std::string_view View(const SStringRecord &record) const{
+            return std::string_view(DArena.data() + record.DOffset, record.DLength);
+        }
+
+        std::size_t Offset() const{
+            return (std::size_t)XML_GetCurrentByteIndex(DParser);
+        }
+
+        // Queues the character data collected since the last element event
+        void FlushCharData(){
+            if(DCharData.empty()){
+                return;
+            }
+            DEvents.push_back({SXMLEntity::EType::CharData, InvalidXMLNameID, Store(DCharData.data(), DCharData.size()), 0, 0, DCharDataOffset});
+            DCharData.clear();
+        }
+
+        static void StartElementHandler(void *user, const XML_Char *name, const XML_Char **attrs){
+            SEventParser *Parser = (SEventParser *)user;
+            Parser->FlushCharData();
+            SEventRecord Event{SXMLEntity::EType::StartElement, Parser->DNames.Intern(name), {0, 0}, Parser->DAttributes.size(), 0, Parser->Offset()};
+            for(std::size_t Index = 0; attrs[Index]; Index += 2){
+                TXMLNameID Name = Parser->DNames.Intern(attrs[Index]);
+                SStringRecord Value = Parser->Store(attrs[Index + 1], std::strlen(attrs[Index + 1]));
+                Parser->DAttributes.push_back({Name, Value});
+                Event.DAttributeCount++;
+            }
+            Parser->DEvents.push_back(Event);
+        }
+
+        static void EndElementHandler(void *user, const XML_Char *name){
+            SEventParser *Parser = (SEventParser *)user;
+            Parser->FlushCharData();
+            Parser->DEvents.push_back({SXMLEntity::EType::EndElement, Parser->DNames.Intern(name), {0, 0}, 0, 0, Parser->Offset()});
+        }
+
+        static void CharacterDataHandler(void *user, const XML_Char *s, int len){
+            SEventParser *Parser = (SEventParser *)user;
+            if(Parser->DSkipCData){
+                return;
+            }
+            if(Parser->DCharData.empty()){
+                Parser->DCharDataOffset = Parser->Offset();
+            }
+            Parser->AppendCharData(s, len);
+        }
+
+        // Expat splits text at buffer boundaries and references; merge the
+        // fragments, splitting only at the optional length cap
+        void AppendCharData(const char *s, std::size_t len){
+            while(DMaxCharData && DCharData.size() + len >= DMaxCharData){
+                std::size_t Length = DMaxCharData - DCharData.size();
+                DCharData.append(s, Length);
+                FlushCharData();
+                s += Length;
+                len -= Length;
+            }
+            DCharData.append(s, len);
+        }
+
+        // Feeds one chunk from src straight into expat's buffer and returns
+        // true once the document is finished or has failed to parse
+        bool ParseChunk(CDataSource &src, std::size_t chunksize){
+            void *Buffer = XML_GetBuffer(DParser, (int)chunksize);
+            if(!Buffer){
+                return true;
+            }
+            std::size_t Length = src.Read((char *)Buffer, chunksize);
+            bool Final = Length == 0;
+            if(XML_ParseBuffer(DParser, (int)Length, Final) == XML_STATUS_ERROR){
+                Final = true;
+            }
+            if(Final){
+                FlushCharData();
+            }
+            return Final;
+        }
+
+        // Parses caller owned memory, returning false on a parse error
+        bool Parse(std::string_view data, bool final){
+            const std::size_t MaxPiece = 1 << 30;
+            do{
+                std::size_t Length = std::min(data.size(), MaxPiece);
+                bool Last = Length == data.size();
+                if(XML_Parse(DParser, data.data(), (int)Length, final && Last) == XML_STATUS_ERROR){
+                    return false;
+                }
+                data.remove_prefix(Length);
+            }while(!data.empty());
+            if(final){
+                FlushCharData();
+            }
+            return true;
+        }
+    };
+
+    // A run of sibling elements parsed on its own inside a wrapper element,
+    // with names interned into a private table
+    struct SSegment{
+        CXMLNameTable DNames;
+        SEventParser DParser;
+        // Reader name table ID of each private ID, filled in on first use
+        std::vector<TXMLNameID> DGlobalIDs;
+        std::size_t DBegin = 0;
+        std::size_t DEnd = 0;
+        bool DValid = false;
+
+        SSegment(std::size_t maxchardata) : DNames(false), DParser(DNames, maxchardata){
+
+        }
+    };
+
+    // Hand written tokenizer for memory-resident documents restricted to the
+    // plain ASCII subset of XML that svg.c and similar writers produce. It
+    // records the same events expat would, and reports Unsupported as soon
+    // as it meets anything else, including every kind of malformed input,
+    // so that expat can take over and produce its exact output.
+    struct SFastTokenizer{
+        enum class EStatus{Continue, Finished, Unsupported};
+
+        std::string_view DData;
+        std::size_t DPosition = 0;
+        std::vector<std::pair<std::string_view, TXMLNameID>> DOpen;
+        bool DRootClosed = false;
+
+        void Reset(std::string_view data){
+            DData = data;
+            DPosition = 0;
+            DOpen.clear();
+            DRootClosed = false;
+        }
+
+        static bool IsSpace(char ch){
+            return ch == ' ' || ch == '\t' || ch == '\n';
+        }
+
+        static bool IsNameStart(char ch){
+            return std::isalpha((unsigned char)ch) || ch == '_' || ch == ':';
+        }
+
+        static bool IsNameChar(char ch){
+            return std::isalnum((unsigned char)ch) || ch == '_' || ch == ':' || ch == '-' || ch == '.';
+        }
+
+        // End of the name starting at position, or position if there is none
+        std::size_t ScanName(std::size_t position) const{
+            if(position >= DData.size() || !IsNameStart(DData[position])){
+                return position;
+            }
+            for(position++; position < DData.size() && IsNameChar(DData[position]); position++);
+            return position;
+        }
+
+        std::size_t SkipSpace(std::size_t position) const{
+            for(; position < DData.size() && IsSpace(DData[position]); position++);
+            return position;
+        }
+
+        // Whether text holds only characters this tokenizer accepts
+        static bool PlainText(std::string_view text){
+            std::size_t Index = 0;
+            while((Index += FindSpecial(text.data() + Index, text.size() - Index, '\t', '\t', '\t')) < text.size()){
+                if(!IsSpace(text[Index])){
+                    return false;
+                }
+                Index++;
+            }
+            return true;
+        }
+
+        // Decodes the reference at position into out, moving position past
+        // it; returns the decoded length or 0 if it is not supported
+        std::size_t DecodeReference(std::size_t &position, char *out) const{
+            std::size_t End = DData.substr(0, position + 16).find(';', position);
+            if(End == std::string_view::npos){
+                return 0;
+            }
+            std::string_view Name = DData.substr(position + 1, End - position - 1);
+            position = End + 1;
+            static const std::pair<std::string_view, char> Predefined[] = {{"lt", '<'}, {"gt", '>'}, {"amp", '&'}, {"quot", '"'}, {"apos", '\''}};
+            for(auto &Entity : Predefined){
+                if(Name == Entity.first){
+                    out[0] = Entity.second;
+                    return 1;
+                }
+            }
+            if(Name.size() < 2 || Name[0] != '#'){
+                return 0;
+            }
+            bool Hex = Name[1] == 'x';
+            Name.remove_prefix(Hex ? 2 : 1);
+            if(Name.empty()){
+                return 0;
+            }
+            std::uint32_t Code = 0;
+            for(char Ch : Name){
+                std::uint32_t Digit;
+                if(std::isdigit((unsigned char)Ch)){
+                    Digit = Ch - '0';
+                }
+                else if(Hex && std::isxdigit((unsigned char)Ch)){
+                    Digit = (std::tolower((unsigned char)Ch) - 'a') + 10;
+                }
+                else{
+                    return 0;
+                }
+                Code = Code * (Hex ? 16 : 10) + Digit;
+                if(Code > 0x10FFFF){
+                    return 0;
+                }
+            }
+            // Same legal character ranges expat checks
+            if((Code < 0x20 && Code != 0x9 && Code != 0xA && Code != 0xD) || (Code >= 0xD800 && Code <= 0xDFFF) || Code == 0xFFFE || Code == 0xFFFF){
+                return 0;
+            }
+            if(Code < 0x80){
+                out[0] = (char)Code;
+                return 1;
+            }
+            if(Code < 0x800){
+                out[0] = (char)(0xC0 | (Code >> 6));
+                out[1] = (char)(0x80 | (Code & 0x3F));
+                return 2;
+            }
+            if(Code < 0x10000){
+                out[0] = (char)(0xE0 | (Code >> 12));
+                out[1] = (char)(0x80 | ((Code >> 6) & 0x3F));
+                out[2] = (char)(0x80 | (Code & 0x3F));
+                return 3;
+            }
+            out[0] = (char)(0xF0 | (Code >> 18));
+            out[1] = (char)(0x80 | ((Code >> 12) & 0x3F));
+            out[2] = (char)(0x80 | ((Code >> 6) & 0x3F));
+            out[3] = (char)(0x80 | (Code & 0x3F));
+            return 4;
+        }
+
+        // Character data up to the next tag
+        EStatus Text(SEventParser &parser){
+            std::size_t Position = DPosition;
+            while(true){
+                std::size_t Next = Position + FindSpecial(DData.data() + Position, DData.size() - Position, '<', '&', '>');
+                if(Next > Position){
+                    if(parser.DCharData.empty()){
+                        parser.DCharDataOffset = Position;
+                    }
+                    parser.AppendCharData(DData.data() + Position, Next - Position);
+                }
+                if(Next == DData.size()){
+                    return EStatus::Unsupported;
+                }
+                char Ch = DData[Next];
+                if(Ch == '<'){
+                    DPosition = Next;
+                    return EStatus::Continue;
+                }
+                if(Ch == '&'){
+                    char Decoded[4];
+                    Position = Next;
+                    std::size_t Length = DecodeReference(Position, Decoded);
+                    if(!Length){
+                        return EStatus::Unsupported;
+                    }
+                    if(parser.DCharData.empty()){
+                        parser.DCharDataOffset = Next;
+                    }
+                    parser.AppendCharData(Decoded, Length);
+                    continue;
+                }
+                // "]]>" may not appear in text
+                if((Ch == '>' && Next >= 2 && DData[Next - 1] == ']' && DData[Next - 2] == ']') || (Ch != '>' && !IsSpace(Ch))){
+                    return EStatus::Unsupported;
+                }
+                if(parser.DCharData.empty()){
+                    parser.DCharDataOffset = Next;
+                }
+                parser.AppendCharData(DData.data() + Next, 1);
+                Position = Next + 1;
+            }
+        }
+
+        EStatus StartTag(SEventParser &parser){
+            std::size_t NameEnd = ScanName(DPosition + 1);
+            if(NameEnd == DPosition + 1 || DRootClosed){
+                return EStatus::Unsupported;
+            }
+            std::string_view Name = DData.substr(DPosition + 1, NameEnd - DPosition - 1);
+            parser.FlushCharData();
+            SEventRecord Event{SXMLEntity::EType::StartElement, parser.DNames.Intern(Name), {0, 0}, parser.DAttributes.size(), 0, DPosition};
+            std::size_t Position = NameEnd;
+            bool Empty = false;
+            while(true){
+                std::size_t Next = SkipSpace(Position);
+                if(Next == DData.size()){
+                    return EStatus::Unsupported;
+                }
+                if(DData[Next] == '>'){
+                    Position = Next + 1;
+                    break;
+                }
+                if(DData[Next] == '/'){
+                    if(Next + 1 == DData.size() || DData[Next + 1] != '>'){
+                        return EStatus::Unsupported;
+                    }
+                    Position = Next + 2;
+                    Empty = true;
+                    break;
+                }
+                // Attributes must be separated by whitespace
+                std::size_t AttributeEnd = ScanName(Next);
+                if(Next == Position || AttributeEnd == Next){
+                    return EStatus::Unsupported;
+                }
+                TXMLNameID AttributeName = parser.DNames.Intern(DData.substr(Next, AttributeEnd - Next));
+                for(std::size_t Index = Event.DAttributeBegin; Index < parser.DAttributes.size(); Index++){
+                    if(parser.DAttributes[Index].DName == AttributeName){
+                        return EStatus::Unsupported;
+                    }
+                }
+                Position = SkipSpace(AttributeEnd);
+                if(Position == DData.size() || DData[Position] != '='){
+                    return EStatus::Unsupported;
+                }
+                Position = SkipSpace(Position + 1);
+                if(Position == DData.size() || (DData[Position] != '"' && DData[Position] != '\'')){
+                    return EStatus::Unsupported;
+                }
+                char Quote = DData[Position++];
+                SStringRecord Value{parser.DArena.size(), 0};
+                while(true){
+                    Next = Position + FindSpecial(DData.data() + Position, DData.size() - Position, Quote, '&', '<');
+                    parser.DArena.insert(parser.DArena.end(), DData.data() + Position, DData.data() + Next);
+                    if(Next == DData.size()){
+                        return EStatus::Unsupported;
+                    }
+                    char Ch = DData[Next];
+                    Position = Next + 1;
+                    if(Ch == Quote){
+                        break;
+                    }
+                    if(Ch == '&'){
+                        char Decoded[4];
+                        Position = Next;
+                        std::size_t Length = DecodeReference(Position, Decoded);
+                        if(!Length){
+                            return EStatus::Unsupported;
+                        }
+                        parser.DArena.insert(parser.DArena.end(), Decoded, Decoded + Length);
+                    }
+                    else if(IsSpace(Ch)){
+                        // Literal whitespace in values is normalized to spaces
+                        parser.DArena.push_back(' ');
+                    }
+                    else{
+                        return EStatus::Unsupported;
+                    }
+                }
+                Value.DLength = parser.DArena.size() - Value.DOffset;
+                parser.DAttributes.push_back({AttributeName, Value});
+                Event.DAttributeCount++;
+            }
+            parser.DEvents.push_back(Event);
+            if(Empty){
+                parser.DEvents.push_back({SXMLEntity::EType::EndElement, Event.DNameID, {0, 0}, 0, 0, DPosition});
+                DRootClosed = DOpen.empty();
+            }
+            else{
+                DOpen.emplace_back(Name, Event.DNameID);
+            }
+            DPosition = Position;
+            return EStatus::Continue;
+        }
+
+        EStatus EndTag(SEventParser &parser){
+            std::size_t NameEnd = ScanName(DPosition + 2);
+            if(DOpen.empty() || DData.substr(DPosition + 2, NameEnd - DPosition - 2) != DOpen.back().first){
+                return EStatus::Unsupported;
+            }
+            std::size_t Position = SkipSpace(NameEnd);
+            if(Position == DData.size() || DData[Position] != '>'){
+                return EStatus::Unsupported;
+            }
+            parser.FlushCharData();
+            parser.DEvents.push_back({SXMLEntity::EType::EndElement, DOpen.back().second, {0, 0}, 0, 0, DPosition});
+            DOpen.pop_back();
+            DRootClosed = DOpen.empty();
+            DPosition = Position + 1;
+            return EStatus::Continue;
+        }
+
+        // Comments and CDATA sections; anything else starting "<!" such as
+        // a DOCTYPE is left to expat
+        EStatus Markup(SEventParser &parser){
+            std::string_view Rest = DData.substr(DPosition);
+            if(Rest.compare(0, 4, "<!--") == 0){
+                // "--" may only appear as part of the closing "-->"
+                std::size_t End = DData.find("--", DPosition + 4);
+                if(End == std::string_view::npos || End + 2 >= DData.size() || DData[End + 2] != '>' || !PlainText(DData.substr(DPosition + 4, End - DPosition - 4))){
+                    return EStatus::Unsupported;
+                }
+                DPosition = End + 3;
+                return EStatus::Continue;
+            }
+            if(Rest.compare(0, 9, "<![CDATA[") == 0 && !DOpen.empty()){
+                std::size_t End = DData.find("]]>", DPosition + 9);
+                if(End == std::string_view::npos){
+                    return EStatus::Unsupported;
+                }
+                std::string_view Content = DData.substr(DPosition + 9, End - DPosition - 9);
+                if(!PlainText(Content)){
+                    return EStatus::Unsupported;
+                }
+                if(!Content.empty()){
+                    if(parser.DCharData.empty()){
+                        parser.DCharDataOffset = DPosition;
+                    }
+                    parser.AppendCharData(Content.data(), Content.size());
+                }
+                DPosition = End + 3;
+                return EStatus::Continue;
+            }
+            return EStatus::Unsupported;
+        }
+
+        // Processing instructions, plus a plain UTF-8 XML declaration
+        EStatus ProcessingInstruction(){
+            std::size_t NameEnd = ScanName(DPosition + 2);
+            std::string_view Target = DData.substr(DPosition + 2, NameEnd - DPosition - 2);
+            std::size_t End = DData.find("?>", NameEnd);
+            if(Target.empty() || End == std::string_view::npos || (End != NameEnd && !IsSpace(DData[NameEnd])) || !PlainText(DData.substr(NameEnd, End - NameEnd))){
+                return EStatus::Unsupported;
+            }
+            if(Target.size() == 3 && std::tolower((unsigned char)Target[0]) == 'x' && std::tolower((unsigned char)Target[1]) == 'm' && std::tolower((unsigned char)Target[2]) == 'l'){
+                if(DPosition || Target != "xml" || !PlainDeclaration(DData.substr(NameEnd, End - NameEnd))){
+                    return EStatus::Unsupported;
+                }
+            }
+            DPosition = End + 2;
+            return EStatus::Continue;
+        }
+
+        // Whether an XML declaration's pseudo attributes are exactly what a
+        // plain UTF-8 1.0 document would declare
+        static bool PlainDeclaration(std::string_view declaration){
+            static const std::string_view Names[] = {"version", "encoding", "standalone"};
+            std::size_t NameIndex = 0;
+            bool First = true;
+            while(true){
+                std::size_t Start = 0;
+                while(Start < declaration.size() && IsSpace(declaration[Start])){
+                    Start++;
+                }
+                if(Start == declaration.size()){
+                    return !First;
+                }
+                if(!Start){
+                    return false;
+                }
+                declaration.remove_prefix(Start);
+                std::size_t Equals = declaration.find('=');
+                if(Equals == std::string_view::npos || Equals + 2 >= declaration.size()){
+                    return false;
+                }
+                std::string_view Name = declaration.substr(0, Equals);
+                char Quote = declaration[Equals + 1];
+                std::size_t Close = declaration.find(Quote, Equals + 2);
+                if((Quote != '"' && Quote != '\'') || Close == std::string_view::npos){
+                    return false;
+                }
+                std::string_view Value = declaration.substr(Equals + 2, Close - Equals - 2);
+                while(NameIndex < 3 && Names[NameIndex] != Name){
+                    NameIndex++;
+                }
+                if(NameIndex == 3 || (First && NameIndex)){
+                    return false;
+                }
+                if(NameIndex == 0 && Value != "1.0"){
+                    return false;
+                }
+                if(NameIndex == 1 && Value != "UTF-8" && Value != "utf-8"){
+                    return false;
+                }
+                if(NameIndex == 2 && Value != "yes" && Value != "no"){
+                    return false;
+                }
+                NameIndex++;
+                First = false;
+                declaration.remove_prefix(Close + 1);
+            }
+        }
+
+        // Records events for about budget bytes of input
+        EStatus Tokenize(SEventParser &parser, std::size_t budget){
+            std::size_t Stop = DPosition + budget;
+            while(DPosition < Stop){
+                if(!DOpen.empty()){
+                    EStatus Status = Text(parser);
+                    if(Status != EStatus::Continue){
+                        return Status;
+                    }
+                }
+                else{
+                    DPosition = SkipSpace(DPosition);
+                    if(DPosition == DData.size()){
+                        return DRootClosed ? EStatus::Finished : EStatus::Unsupported;
+                    }
+                    if(DData[DPosition] != '<'){
+                        return EStatus::Unsupported;
+                    }
+                }
+                if(DPosition + 1 == DData.size()){
+                    return EStatus::Unsupported;
+                }
+                char Next = DData[DPosition + 1];
+                EStatus Status = Next == '/' ? EndTag(parser) : Next == '!' ? Markup(parser) : Next == '?' ? ProcessingInstruction() : StartTag(parser);
+                if(Status != EStatus::Continue){
+                    return Status;
+                }
+            }
+            return EStatus::Continue;
+        }
+    };
+
+    enum class EMode{Sequential, Fast, ParallelStart, ParallelSegments, Done};
+
+    // Bounds in chunks on the input size worth splitting and on the size of
+    // one segment, which limits the memory held by parsed but unread events
+    static constexpr std::size_t ParallelMinimumChunks = 16;
+    static constexpr std::size_t MaximumSegmentChunks = 128;
+
     std::shared_ptr<CDataSource> DSource;
-    bool reachedEnd = false;
-    char PeekChar() {
-        if (DSource->End()) return '\0';
-        char c;
-        DSource->Peek(c);
-        return c;
-    }
-    char GetChar() {
-        char c;
-        if (DSource->Get(c)) return c;
-        reachedEnd = true;
-        return '\0';
+    CXMLNameTable DNames;
+    SEventParser DParser;
+    SXMLEntityView DView;
+    std::size_t DChunkSize;
+    std::size_t DMaxCharData;
+    std::size_t DThreadCount;
+    bool DFastTokenizer;
+    SFastTokenizer DTokenizer;
+    bool DSkipCData = false;
+    bool DFinished = false;
+    EMode DMode = EMode::Sequential;
+
+    // Events currently being returned
+    SEventParser *DCurrentParser;
+    std::vector<TXMLNameID> *DCurrentGlobalIDs = nullptr;
+    std::size_t DEventIndex = 0;
+    std::size_t DEventEnd = 0;
+
+    // Parallel mode: the document is split into a head and tail parsed
+    // together by DEdge, and segments between them parsed round by round
+    std::string_view DData;
+    std::unique_ptr<SEventParser> DEdge;
+    std::size_t DHeadEnd = 0;
+    std::size_t DHeadEventEnd = 0;
+    std::size_t DTailStart = 0;
+    std::size_t DNextSplit = 0;
+    std::size_t DSegmentSize = 0;
+    std::vector<std::unique_ptr<SSegment>> DSegments;
+    std::size_t DSegmentCount = 0;
+    std::size_t DSegmentIndex = 0;
+    // Events returned in parallel mode, skipped again after falling back
+    std::size_t DDelivered = 0;
+    std::size_t DSuppress = 0;
+
+    SImplementation(std::shared_ptr<CDataSource> src, std::size_t chunksize, std::size_t maxchardata, std::size_t threads, bool fasttokenizer) : DSource(src), DParser(DNames, maxchardata), DChunkSize(chunksize ? chunksize : 1), DMaxCharData(maxchardata), DFastTokenizer(fasttokenizer){
+        DThreadCount = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+        DCurrentParser = &DParser;
+        ChooseMode();
+    }
+
+    void ChooseMode(){
+        DMode = EMode::Sequential;
+        if(DThreadCount > 1 && DSource->Contents().size() >= DChunkSize * ParallelMinimumChunks){
+            DMode = EMode::ParallelStart;
+        }
+        else if(DFastTokenizer && !DSource->Contents().empty()){
+            DMode = EMode::Fast;
+            DTokenizer.Reset(DSource->Contents());
+        }
+    }
+
+    // Starts over on a new source, keeping the parsers, buffer capacity and
+    // interned names
+    void Reset(std::shared_ptr<CDataSource> src){
+        DParser.Reset();
+        DSource = src;
+        DCurrentParser = &DParser;
+        DCurrentGlobalIDs = nullptr;
+        DEventIndex = DEventEnd = 0;
+        DFinished = false;
+        DEdge.reset();
+        DData = std::string_view();
+        DDelivered = DSuppress = 0;
+        ChooseMode();
+    }
+
+    void Deliver(SEventParser &parser, std::vector<TXMLNameID> *globalids, std::size_t begin, std::size_t end){
+        DCurrentParser = &parser;
+        DCurrentGlobalIDs = globalids;
+        DEventIndex = begin;
+        DEventEnd = end;
+    }
+
+    TXMLNameID GlobalID(TXMLNameID id){
+        if(!DCurrentGlobalIDs){
+            return id;
+        }
+        std::vector<TXMLNameID> &GlobalIDs = *DCurrentGlobalIDs;
+        if(id >= GlobalIDs.size()){
+            GlobalIDs.resize(id + 1, InvalidXMLNameID);
+        }
+        if(GlobalIDs[id] == InvalidXMLNameID){
+            GlobalIDs[id] = DNames.Intern(DCurrentParser->DNames.Name(id));
+        }
+        return GlobalIDs[id];
+    }
+
+    // Position of the first start tag at or after position, or npos
+    std::size_t FindSplit(std::size_t position) const{
+        while(position < DData.size()){
+            const char *Tag = (const char *)std::memchr(DData.data() + position, '<', DData.size() - position);
+            if(!Tag || Tag + 1 == DData.data() + DData.size()){
+                break;
+            }
+            unsigned char Next = Tag[1];
+            position = Tag - DData.data();
+            if(std::isalpha(Next) || Next == '_' || Next == ':' || Next >= 0x80){
+                return position;
+            }
+            position++;
+        }
+        return std::string_view::npos;
+    }
+
+    // Whether the document declares anything that changes how a fragment
+    // parsed on its own would be read
+    bool ParallelSafeProlog() const{
+        std::string_view Prolog = DData.substr(0, DHeadEnd);
+        if(Prolog.find("<!DOCTYPE") != std::string_view::npos){
+            return false;
+        }
+        if(Prolog.compare(0, 5, "<?xml") == 0){
+            std::string_view Declaration = Prolog.substr(0, Prolog.find("?>"));
+            std::size_t Encoding = Declaration.find("encoding");
+            if(Encoding != std::string_view::npos){
+                std::string_view Value = Declaration.substr(Encoding + 8);
+                std::size_t Quote = Value.find_first_of("\"'");
+                if(Quote == std::string_view::npos){
+                    return false;
+                }
+                Value = Value.substr(Quote + 1, 5);
+                if(Value != "UTF-8" && Value != "utf-8" && Value.substr(0, 5) != "US-AS" && Value.substr(0, 5) != "us-as"){
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Parses the head and tail as one document; the tail must start with an
+    // element event at the head boundary or the split was not at the top
+    // level of content
+    bool ParseEdge(){
+        DEdge->Reset();
+        if(!DEdge->Parse(DData.substr(0, DHeadEnd), false) || !DEdge->Parse(DData.substr(DTailStart), true)){
+            return false;
+        }
+        std::vector<SEventRecord> &Events = DEdge->DEvents;
+        DHeadEventEnd = 0;
+        while(DHeadEventEnd < Events.size() && Events[DHeadEventEnd].DOffset < DHeadEnd){
+            DHeadEventEnd++;
+        }
+        return DHeadEventEnd < Events.size() && Events[DHeadEventEnd].DOffset == DHeadEnd && Events[DHeadEventEnd].DType == SXMLEntity::EType::StartElement;
+    }
+
+    // Parses a segment wrapped in a synthetic root; it must be balanced and
+    // begin with an element right after the wrapper
+    static void ParseSegment(SSegment &segment, std::string_view data){
+        static const char WrapperBegin[] = "<r>";
+        static const char WrapperEnd[] = "</r>";
+        SEventParser &Parser = segment.DParser;
+        Parser.Reset();
+        segment.DValid = Parser.Parse(WrapperBegin, false) && Parser.Parse(data.substr(segment.DBegin, segment.DEnd - segment.DBegin), false) && Parser.Parse(WrapperEnd, true);
+        std::vector<SEventRecord> &Events = Parser.DEvents;
+        segment.DValid = segment.DValid && Events.size() > 2 && Events[1].DOffset == sizeof(WrapperBegin) - 1;
+    }
+
+    // Splits off and parses the next round of segments, one per thread, along
+    // with the head and tail on the first round
+    bool ParseRound(bool withedge){
+        std::size_t SegmentCount = DThreadCount - (withedge ? 1 : 0);
+        DSegmentCount = 0;
+        while(DSegmentCount < SegmentCount && DNextSplit < DTailStart){
+            std::size_t End = FindSplit(DNextSplit + DSegmentSize);
+            if(End == std::string_view::npos || End > DTailStart){
+                End = DTailStart;
+            }
+            if(DSegments.size() == DSegmentCount){
+                DSegments.push_back(std::make_unique<SSegment>(DMaxCharData));
+            }
+            DSegments[DSegmentCount]->DBegin = DNextSplit;
+            DSegments[DSegmentCount]->DEnd = End;
+            DSegmentCount++;
+            DNextSplit = End;
+        }
+        bool EdgeValid = true;
+        std::vector<std::function<void()>> Tasks;
+        if(withedge){
+            Tasks.push_back([this, &EdgeValid](){
+                EdgeValid = ParseEdge();
+            });
+        }
+        for(std::size_t Index = 0; Index < DSegmentCount; Index++){
+            Tasks.push_back([this, Index](){
+                ParseSegment(*DSegments[Index], DData);
+            });
+        }
+        std::vector<std::thread> Threads;
+        for(std::size_t Index = 1; Index < Tasks.size(); Index++){
+            Threads.emplace_back(Tasks[Index]);
+        }
+        if(!Tasks.empty()){
+            Tasks[0]();
+        }
+        for(auto &Thread : Threads){
+            Thread.join();
+        }
+        for(std::size_t Index = 0; Index < DSegmentCount; Index++){
+            if(!DSegments[Index]->DValid){
+                return false;
+            }
+        }
+        DSegmentIndex = 0;
+        return EdgeValid;
+    }
+
+    bool StartParallel(){
+        DData = DSource->Contents();
+        DSegmentSize = std::clamp(DData.size() / DThreadCount, DChunkSize, DChunkSize * MaximumSegmentChunks);
+        DHeadEnd = FindSplit(DSegmentSize / 2);
+        DTailStart = FindSplit(DData.size() - std::min(DData.size(), DSegmentSize / 2));
+        if(DHeadEnd == std::string_view::npos || DTailStart == std::string_view::npos || DTailStart <= DHeadEnd || !ParallelSafeProlog()){
+            return false;
+        }
+        if(!DEdge){
+            DEdge = std::make_unique<SEventParser>(DNames, DMaxCharData);
+        }
+        DNextSplit = DHeadEnd;
+        return ParseRound(true);
+    }
+
+    // Gives up on the split and parses the source from the start, skipping
+    // the events that have already been returned
+    void FallBack(){
+        DParser.Reset();
+        DMode = EMode::Sequential;
+        DSuppress = DDelivered;
+        Deliver(DParser, nullptr, 0, 0);
+    }
+
+    // Makes the next batch of events current, false once there are no more
+    bool NextEvents(){
+        switch(DMode){
+            case EMode::Sequential:
+                if(DFinished){
+                    return false;
+                }
+                DParser.Clear();
+                DParser.DSkipCData = DSkipCData && !DSuppress;
+                DFinished = DParser.ParseChunk(*DSource, DChunkSize);
+                Deliver(DParser, nullptr, 0, DParser.DEvents.size());
+                return true;
+            case EMode::Fast:{
+                // Events are always recorded with character data so that the
+                // count returned matches expat's if it has to take over
+                DParser.Clear();
+                SFastTokenizer::EStatus Status = DTokenizer.Tokenize(DParser, DChunkSize);
+                if(Status == SFastTokenizer::EStatus::Unsupported){
+                    FallBack();
+                    return true;
+                }
+                if(Status == SFastTokenizer::EStatus::Finished){
+                    DMode = EMode::Done;
+                }
+                Deliver(DParser, nullptr, 0, DParser.DEvents.size());
+                return true;
+            }
+            case EMode::ParallelStart:
+                if(!StartParallel()){
+                    FallBack();
+                    return true;
+                }
+                DMode = EMode::ParallelSegments;
+                Deliver(*DEdge, nullptr, 0, DHeadEventEnd);
+                return true;
+            case EMode::ParallelSegments:
+                if(DSegmentIndex == DSegmentCount){
+                    if(DNextSplit == DTailStart){
+                        DMode = EMode::Done;
+                        Deliver(*DEdge, nullptr, DHeadEventEnd, DEdge->DEvents.size());
+                        return true;
+                    }
+                    if(!ParseRound(false)){
+                        FallBack();
+                        return true;
+                    }
+                }
+                else{
+                    // Everything but the wrapper element's start and end
+                    SSegment &Segment = *DSegments[DSegmentIndex++];
+                    Deliver(Segment.DParser, &Segment.DGlobalIDs, 1, Segment.DParser.DEvents.size() - 1);
+                }
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool End() const{
+        if(DEventIndex != DEventEnd){
+            return false;
+        }
+        if(DMode == EMode::Sequential){
+            return DFinished || DSource->End();
+        }
+        return DMode == EMode::Done;
+    }
+
+    bool ReadEntityView(SXMLEntityView &entity, bool skipcdata){
+        DSkipCData = skipcdata;
+        while(true){
+            while(DEventIndex < DEventEnd){
+                const SEventRecord &Event = DCurrentParser->DEvents[DEventIndex++];
+                if(DSuppress){
+                    DSuppress--;
+                    continue;
+                }
+                if(DMode != EMode::Sequential){
+                    DDelivered++;
+                }
+                if(skipcdata && Event.DType == SXMLEntity::EType::CharData){
+                    continue;
+                }
+                entity.DType = Event.DType;
+                entity.DNameID = Event.DNameID == InvalidXMLNameID ? InvalidXMLNameID : GlobalID(Event.DNameID);
+                entity.DNameData = entity.DNameID == InvalidXMLNameID ? DCurrentParser->View(Event.DNameData) : DNames.Name(entity.DNameID);
+                entity.DAttributes.clear();
+                entity.DAttributeIDs.clear();
+                for(std::size_t Index = 0; Index < Event.DAttributeCount; Index++){
+                    const SAttributeRecord &Attribute = DCurrentParser->DAttributes[Event.DAttributeBegin + Index];
+                    TXMLNameID Name = GlobalID(Attribute.DName);
+                    entity.DAttributes.emplace_back(DNames.Name(Name), DCurrentParser->View(Attribute.DValue));
+                    entity.DAttributeIDs.push_back(Name);
+                }
+                return true;
+            }
+            if(!NextEvents()){
+                return false;
+            }
+        }
+    }
+
+    bool ReadEntity(SXMLEntity &entity, bool skipcdata){
+        if(!ReadEntityView(DView, skipcdata)){
+            return false;
+        }
+        entity.DType = DView.DType;
+        entity.DNameData.assign(DView.DNameData);
+        entity.DAttributes.clear();
+        for(auto &Attribute : DView.DAttributes){
+            entity.DAttributes.emplace_back(std::string(std::get<0>(Attribute)), std::string(std::get<1>(Attribute)));
+        }
+        return true;
     }
 };
 /**
  * @brief Constructs an XML reader.
  * @param src Shared pointer to the data source to read XML from.
+ * @param chunksize Number of bytes pulled from the source per parse step.
+ * @param maxchardata Longest CharData entity before text is split, 0 for no limit.
+ * @param threads Threads used to parse a memory-resident source, 0 for one
+ *        per hardware thread. With more than one, a source whose Contents()
+ *        holds the whole document is split between top-level sibling
+ *        elements and the pieces are parsed concurrently; entities are still
+ *        returned in document order, and if a split turns out not to be safe
+ *        the reader falls back to parsing sequentially.
+ * @param fasttokenizer Whether to read a memory-resident source with a
+ *        SIMD tokenizer specialised for plain ASCII SVG style documents
+ *        instead of expat when parsing sequentially. The entities returned
+ *        are identical either way; on anything it does not handle the
+ *        tokenizer hands the document back to expat.
  */
 
-CXMLReader::CXMLReader(std::shared_ptr< CDataSource > src){
-    DImplementation = std::make_unique<SImplementation>();
-    DImplementation->DSource = src;
-    DImplementation->reachedEnd = false;
+CXMLReader::CXMLReader(std::shared_ptr< CDataSource > src, std::size_t chunksize, std::size_t maxchardata, std::size_t threads, bool fasttokenizer){
+    DImplementation = std::make_unique<SImplementation>(src, chunksize, maxchardata, threads, fasttokenizer);
 }
 /**
  * @brief Destructor for the XML reader.
  */
 CXMLReader::~CXMLReader(){
 
+}
+/**
+ * @brief Restarts the reader on a new data source.
+ *
+ * Reusing one reader for a series of documents keeps its parser, buffers
+ * and name table instead of building them again for every document.
+ * @param src Shared pointer to the data source to read XML from.
+ */
+void CXMLReader::Reset(std::shared_ptr< CDataSource > src){
+    DImplementation->Reset(src);
 }
 /**
  * @brief Checks if you reached the end of the XML input
  * @return True if end of XML stream reached, false otherwise.
  */
 bool CXMLReader::End() const{
-    return DImplementation->reachedEnd;
+    return DImplementation->End();
 }
 /**
  * @brief Reads the next XML entity.
+ *
+ * Convenience wrapper around ReadEntityView() that copies the entity into
+ * owning strings.
  * @param entity Reference to store the entity data.
- * @param skipcdata Whether to skip CDATA content.
+ * @param skipcdata Whether to skip character data.
  * @return True if an entity was successfully read, false otherwise.
  */
 bool CXMLReader::ReadEntity(SXMLEntity &entity, bool skipcdata){
-  ;
-
+    return DImplementation->ReadEntity(entity, skipcdata);
+}
+/**
+ * @brief Reads the next XML entity without copying its strings.
+ *
+ * Entities are parsed from the source one chunk at a time, and only once
+ * all previously parsed entities have been returned. Consecutive character
+ * data is returned as a single CharData entity. The views in entity point
+ * into storage owned by the reader and stay valid until the next read;
+ * reusing the same entity object avoids any allocation once warmed up.
+ * @param entity Reference to store the entity views.
+ * @param skipcdata Whether to skip character data.
+ * @return True if an entity was successfully read, false otherwise.
+ */
+bool CXMLReader::ReadEntityView(SXMLEntityView &entity, bool skipcdata){
+    return DImplementation->ReadEntityView(entity, skipcdata);
+}
+/**
+ * @brief Gets the table of element and attribute names seen by this reader.
+ *
+ * The table starts with the common SVG vocabulary preloaded. Name IDs in
+ * entities returned by ReadEntityView() index into it, and IDs for names
+ * looked up in advance with Find() or Intern() can be compared directly.
+ * @return Reference to the reader's name table.
+ */
+CXMLNameTable &CXMLReader::NameTable(){
+    return DImplementation->DNames;
 }
@@ -5,11 +5,26 @@
  * Implements the basic functions for creating SVG documents.
  */
 #include "svg.h"
+#include "svg_number.h"
 #include <stdlib.h>
 #include <string.h>
-#include <stdio.h>
-#include <stdarg.h>
+#include <math.h>
 
+/**
+ * @brief Number of elements scaled together by the batch functions.
+ */
+#define SVG_BATCH_BLOCK 64
+
+/**
+ * @brief Size of the local buffer path data is formatted into before it is
+ * emitted.
+ */
+#define SVG_PATH_BLOCK 1024
+
+/**
+ * @brief Initial size of the element buffer of an unbuffered context.
+ */
+#define SVG_ELEMENT_BLOCK 256
 
 /**
  * @brief Opaque SVG drawing context.
@@ -21,14 +36,166 @@ struct SVG_CONTEXT {
     svg_write_fn write_fn;
     svg_cleanup_fn cleanup_fn;
     svg_user_context_ptr user;
+    char *buffer;
+    size_t buffer_size;
+    size_t buffer_length;
+    svg_return_t error;
+    int unbuffered;
+    int precision;
+    svg_px_t width;
+    svg_px_t height;
+    svg_decimate_t decimation;
 
 };
 
+/**
+ * @brief Grows the element buffer of an unbuffered context.
+ *
+ * An unbuffered context assembles each element in a buffer that is doubled
+ * until it holds length more bytes and a null terminator. A failure is kept
+ * on the context like a write error, so the partly assembled element is
+ * never completed by later output.
+ *
+ * @param context Pointer to the SVG context
+ * @param length  Number of bytes about to be appended
+ *
+ * @return SVG_OK on success, or SVG_ERR_MEMORY if allocation fails
+ */
+static svg_return_t svg_grow(svg_context_ptr context, size_t length){
+    size_t size = context->buffer_size ? context->buffer_size : SVG_ELEMENT_BLOCK;
+    while (context->buffer_length + length >= size) {
+        size *= 2;
+    }
+    char *buffer = (char *)realloc(context->buffer, size);
+    if (!buffer) {
+        context->error = SVG_ERR_MEMORY;
+        return context->error;
+    }
+    context->buffer = buffer;
+    context->buffer_size = size;
+    return SVG_OK;
+}
+
+/**
+ * @brief Emits text through the context output buffer.
+ *
+ * Appends the text to the output buffer, flushing first if it would not fit.
+ * Text larger than the whole buffer is passed straight to the write
+ * callback. An unbuffered context grows its buffer instead, so that
+ * svg_end_element() writes the element in one call.
+ *
+ * @param context Pointer to the SVG context
+ * @param text    Null-terminated text to emit
+ * @param length  Length of text in bytes
+ *
+ * @return SVG_OK on success, or the write callback's error code
+ */
+static svg_return_t svg_emit(svg_context_ptr context, const char *text, size_t length){
+    if (context->error != SVG_OK) {
+        return context->error;
+    }
+    if (context->buffer_length + length >= context->buffer_size) {
+        svg_return_t ret = context->unbuffered ? svg_grow(context, length) : svg_flush(context);
+        if (ret != SVG_OK) {
+            return ret;
+        }
+        if (length >= context->buffer_size) {
+            context->error = context->write_fn(context->user, text);
+            return context->error;
+        }
+    }
+    memcpy(context->buffer + context->buffer_length, text, length);
+    context->buffer_length += length;
+    return SVG_OK;
+}
+
+/**
+ * @brief Emits a number prepared by svg_scale_reals().
+ *
+ * The number is formatted in place at the end of the output buffer. Only a
+ * buffer too small to ever hold a number falls back to a local copy.
+ *
+ * @param context Pointer to the SVG context
+ * @param scaled  Value scaled by svg_scale_reals()
+ * @param value   Original value
+ *
+ * @return SVG_OK on success, or the write callback's error code
+ */
+static svg_return_t svg_emit_number(svg_context_ptr context, svg_real_t scaled, svg_real_t value){
+    if (context->error != SVG_OK) {
+        return context->error;
+    }
+    if (context->buffer_length + SVG_NUMBER_BUFFER_SIZE >= context->buffer_size) {
+        if (!context->unbuffered && SVG_NUMBER_BUFFER_SIZE >= context->buffer_size) {
+            char number[SVG_NUMBER_BUFFER_SIZE];
+            size_t length = svg_format_scaled(number, scaled, value, context->precision);
+            return svg_emit(context, number, length);
+        }
+        svg_return_t ret = context->unbuffered ? svg_grow(context, SVG_NUMBER_BUFFER_SIZE) : svg_flush(context);
+        if (ret != SVG_OK) {
+            return ret;
+        }
+    }
+    context->buffer_length += svg_format_scaled(context->buffer + context->buffer_length, scaled, value, context->precision);
+    return SVG_OK;
+}
+
+/**
+ * @brief Completes an element.
+ *
+ * Writes the assembled element of an unbuffered context; buffered
+ * contexts keep it until the buffer fills or is flushed.
+ *
+ * @param context Pointer to the SVG context
+ *
+ * @return SVG_OK on success, or the write callback's error code
+ */
+static svg_return_t svg_end_element(svg_context_ptr context){
+    return context->unbuffered ? svg_flush(context) : SVG_OK;
+}
+
+/**
+ * @brief Formats and emits an element with numeric attributes and a style.
+ *
+ * The element is written piecewise into the output buffer, so neither the
+ * style nor the element as a whole is limited in length.
+ *
+ * @param context Pointer to the SVG context
+ * @param text    width + 1 literal pieces: the text before each number,
+ *                then the text before the style
+ * @param scaled  Values prepared by svg_scale_reals()
+ * @param value   Original values
+ * @param width   Number of numeric attributes
+ * @param style   CSS style string
+ *
+ * @return SVG_OK on success, or the write callback's error code
+ */
+static svg_return_t svg_write_element(svg_context_ptr context, const char *const *text, const svg_real_t *scaled, const svg_real_t *value, size_t width, const char *style){
+    svg_return_t ret = SVG_OK;
+    for (size_t index = 0; index < width && ret == SVG_OK; index++) {
+        ret = svg_emit(context, text[index], strlen(text[index]));
+        if (ret == SVG_OK) {
+            ret = svg_emit_number(context, scaled[index], value[index]);
+        }
+    }
+    if (ret == SVG_OK) {
+        ret = svg_emit(context, text[width], strlen(text[width]));
+    }
+    if (ret == SVG_OK) {
+        ret = svg_emit(context, style, strlen(style));
+    }
+    if (ret == SVG_OK) {
+        ret = svg_emit(context, "\"/>\n", 4);
+    }
+    return ret == SVG_OK ? svg_end_element(context) : ret;
+}
+
 /**
  * @brief Creates a new SVG drawing context.
  *
  * Initializes an SVG context with specified canvas dimensions and sets up
- * user-defined callbacks for writing and cleaning up output.
+ * user-defined callbacks for writing and cleaning up output. The context
+ * uses an output buffer of SVG_DEFAULT_BUFFER_SIZE bytes.
  *
  * @param write_fn   Callback function used to write SVG text
  * @param cleanup_fn Callback function used to clean up user resources
@@ -39,6 +206,26 @@ struct SVG_CONTEXT {
  * @return Pointer to a new SVG context, or NULL if creation fails
  */
 svg_context_ptr svg_create(svg_write_fn write_fn, svg_cleanup_fn cleanup_fn, svg_user_context_ptr user, svg_px_t width, svg_px_t height) {
+    return svg_create_buffered(write_fn, cleanup_fn, user, width, height, SVG_DEFAULT_BUFFER_SIZE);
+}
+
+/**
+ * @brief Creates a new SVG drawing context with a sized output buffer.
+ *
+ * The SVG header is written immediately so that a failing write callback
+ * still causes creation to fail. A buffer_size of zero creates an
+ * unbuffered context.
+ *
+ * @param write_fn    Callback function used to write SVG text
+ * @param cleanup_fn  Callback function used to clean up user resources
+ * @param user        User-defined context passed to callbacks
+ * @param width       Width of the SVG canvas in pixels
+ * @param height      Height of the SVG canvas in pixels
+ * @param buffer_size Size of the output buffer in bytes
+ *
+ * @return Pointer to a new SVG context, or NULL if creation fails
+ */
+svg_context_ptr svg_create_buffered(svg_write_fn write_fn, svg_cleanup_fn cleanup_fn, svg_user_context_ptr user, svg_px_t width, svg_px_t height, size_t buffer_size) {
 
      if (!write_fn || !cleanup_fn || !user || width <= 0 || height <= 0) {
         return NULL;
@@ -50,13 +237,36 @@ svg_context_ptr svg_create(svg_write_fn write_fn, svg_cleanup_fn cleanup_fn, svg
     context->write_fn = write_fn;
     context->cleanup_fn = cleanup_fn;
     context->user = user;
-    char buffer[256];
-    int n = snprintf(buffer, sizeof(buffer), "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" "<svg width=\"%d\" height=\"%d\" xmlns=\"http://www.w3.org/2000/svg\">\n", width, height);
-    if (n < 0 || n >= (int)sizeof(buffer)) {
-        free(context);
-        return NULL;
+    context->buffer = NULL;
+    context->buffer_size = buffer_size;
+    context->buffer_length = 0;
+    context->error = SVG_OK;
+    context->unbuffered = !buffer_size;
+    context->precision = SVG_PRECISION_SHORTEST;
+    context->width = width;
+    context->height = height;
+    context->decimation = SVG_DECIMATE_NONE;
+    if (buffer_size) {
+        context->buffer = (char *)malloc(buffer_size);
+        if (!context->buffer) {
+            free(context);
+            return NULL;
+        }
+    }
+    static const char *const header[] = {"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg width=\"", "\" height=\"", "\" xmlns=\"http://www.w3.org/2000/svg\">\n"};
+    svg_real_t size[2] = {width, height};
+    svg_return_t ret = SVG_OK;
+    for (size_t index = 0; index < 3 && ret == SVG_OK; index++) {
+        ret = svg_emit(context, header[index], strlen(header[index]));
+        if (ret == SVG_OK && index < 2) {
+            ret = svg_emit_number(context, size[index], size[index]);
+        }
     }
-    if (write_fn(user, buffer) != SVG_OK) {
+    if (ret == SVG_OK) {
+        ret = svg_flush(context);
+    }
+    if (ret != SVG_OK) {
+        free(context->buffer);
         free(context);
         return NULL;
     }
@@ -64,11 +274,59 @@ svg_context_ptr svg_create(svg_write_fn write_fn, svg_cleanup_fn cleanup_fn, svg
 
 }
 
+/**
+ * @brief Flushes the context output buffer.
+ *
+ * Null-terminates the buffered text and passes it to the write callback.
+ * A failed write leaves the output incomplete, so its error is kept on the
+ * context and returned by every later flush and element.
+ *
+ * @param context Pointer to the SVG context
+ *
+ * @return SVG_OK on success, SVG_ERR_NULL if context is NULL,
+ *         or the write callback's error code
+ */
+svg_return_t svg_flush(svg_context_ptr context){
+    if (!context) {
+        return SVG_ERR_NULL;
+    }
+    if (context->error != SVG_OK || !context->buffer_length) {
+        return context->error;
+    }
+    context->buffer[context->buffer_length] = '\0';
+    context->buffer_length = 0;
+    context->error = context->write_fn(context->user, context->buffer);
+    return context->error;
+}
+
+/**
+ * @brief Sets the number precision of the context.
+ *
+ * Coordinates and lengths of subsequent elements are written with the
+ * given precision using svg_format_real().
+ *
+ * @param context   Pointer to the SVG context
+ * @param precision SVG_PRECISION_SHORTEST, or 0 to SVG_PRECISION_MAX decimals
+ *
+ * @return SVG_OK on success, SVG_ERR_NULL if context is NULL,
+ *         or SVG_ERR_INVALID_ARG if precision is out of range
+ */
+svg_return_t svg_set_precision(svg_context_ptr context, int precision){
+    if (!context) {
+        return SVG_ERR_NULL;
+    }
+    if (precision != SVG_PRECISION_SHORTEST && (precision < 0 || precision > SVG_PRECISION_MAX)) {
+        return SVG_ERR_INVALID_ARG;
+    }
+    context->precision = precision;
+    return SVG_OK;
+}
+
 /**
  * @brief Destroys an SVG drawing context.
  *
- * Writes the closing </svg> tag, invokes the cleanup callback, and frees
- * the memory associated with the context.
+ * Writes the closing </svg> tag, flushes the output buffer, invokes the
+ * cleanup callback, and frees the memory associated with the context.
  *
  * @param context Pointer to the SVG context to destroy
  *
@@ -80,14 +338,108 @@ svg_return_t svg_destroy(svg_context_ptr context){
         return SVG_ERR_NULL;
     }
     const char* end_tag = "</svg>\n";
-    svg_return_t ret = context->write_fn(context->user, end_tag);
+    svg_return_t ret = svg_emit(context, end_tag, strlen(end_tag));
+    if (ret == SVG_OK) {
+        ret = svg_flush(context);
+    }
     if (ret == SVG_OK) {
         ret = context->cleanup_fn(context->user);
     }
+    free(context->buffer);
     free(context);
     return ret; 
 }
 
+/**
+ * @brief Formats and emits a circle element.
+ *
+ * @param context Pointer to the SVG context
+ * @param scaled  cx, cy and r prepared by svg_scale_reals()
+ * @param value   Original cx, cy and r
+ * @param style   CSS style string
+ *
+ * @return SVG_OK on success, or SVG_ERR_IO if writing fails
+ */
+static svg_return_t svg_write_circle(svg_context_ptr context, const svg_real_t *scaled, const svg_real_t *value, const char *style){
+    static const char *const text[] = {"<circle cx=\"", "\" cy=\"", "\" r=\"", "\" style=\""};
+    return svg_write_element(context, text, scaled, value, 3, style);
+}
+
+/**
+ * @brief Formats and emits a rect element.
+ *
+ * @param context Pointer to the SVG context
+ * @param scaled  x, y, width and height prepared by svg_scale_reals()
+ * @param value   Original x, y, width and height
+ * @param style   CSS style string
+ *
+ * @return SVG_OK on success, or SVG_ERR_IO if writing fails
+ */
+static svg_return_t svg_write_rect(svg_context_ptr context, const svg_real_t *scaled, const svg_real_t *value, const char *style){
+    static const char *const text[] = {"<rect x=\"", "\" y=\"", "\" width=\"", "\" height=\"", "\" style=\""};
+    return svg_write_element(context, text, scaled, value, 4, style);
+}
+
+/**
+ * @brief Formats and emits a line element.
+ *
+ * @param context Pointer to the SVG context
+ * @param scaled  x1, y1, x2 and y2 prepared by svg_scale_reals()
+ * @param value   Original x1, y1, x2 and y2
+ * @param style   CSS style string
+ *
+ * @return SVG_OK on success, or SVG_ERR_IO if writing fails
+ */
+static svg_return_t svg_write_line(svg_context_ptr context, const svg_real_t *scaled, const svg_real_t *value, const char *style){
+    static const char *const text[] = {"<line x1=\"", "\" y1=\"", "\" x2=\"", "\" y2=\"", "\" style=\""};
+    return svg_write_element(context, text, scaled, value, 4, style);
+}
+
+/**
+ * @brief Signature shared by the element writers.
+ */
+typedef svg_return_t (*svg_element_writer)(svg_context_ptr context, const svg_real_t *scaled, const svg_real_t *value, const char *style);
+
+/**
+ * @brief Emits a batch of elements from structure-of-arrays input.
+ *
+ * Values are processed in blocks of SVG_BATCH_BLOCK. Each column of a block
+ * is scaled in one pass by svg_scale_reals() before the elements are
+ * formatted, so the conversion preprocessing runs over contiguous memory.
+ *
+ * @param context Pointer to the SVG context
+ * @param writer  Element writer for the shape
+ * @param columns Array of column pointers, one per numeric attribute
+ * @param width   Number of columns (at most 4)
+ * @param count   Number of elements
+ * @param style   CSS style string shared by all elements
+ *
+ * @return SVG_OK on success, or the first error reported by the writer
+ */
+static svg_return_t svg_write_batch(svg_context_ptr context, svg_element_writer writer, const svg_real_t *const *columns, size_t width, size_t count, const char *style){
+    svg_real_t scaled[4][SVG_BATCH_BLOCK];
+    svg_real_t element_scaled[4];
+    svg_real_t element_value[4];
+
+    for (size_t base = 0; base < count; base += SVG_BATCH_BLOCK) {
+        size_t block = count - base < SVG_BATCH_BLOCK ? count - base : SVG_BATCH_BLOCK;
+        for (size_t column = 0; column < width; column++) {
+            svg_scale_reals(scaled[column], columns[column] + base, block, context->precision);
+        }
+        for (size_t index = 0; index < block; index++) {
+            for (size_t column = 0; column < width; column++) {
+                element_scaled[column] = scaled[column][index];
+                element_value[column] = columns[column][base + index];
+            }
+            svg_return_t ret = writer(context, element_scaled, element_value, style);
+            if (ret != SVG_OK) {
+                return ret;
+            }
+        }
+    }
+    return SVG_OK;
+}
+
 /**
  * @brief Draws a circle element in the SVG.
  *
@@ -104,13 +456,34 @@ svg_return_t svg_circle(svg_context_ptr context, const svg_point_t *center, svg_
     if (!context || !center) {
         return SVG_ERR_NULL;
     }
-    char buffer[256];
     const char* s = style ? style : "";
-    int n = snprintf(buffer, sizeof(buffer), "<circle cx=\"%f\" cy=\"%f\" r=\"%f\" style=\"%s\"/>\n", center->x, center->y, radius, s);
-    if (n < 0 || n >= (int)sizeof(buffer)) {
-        return SVG_ERR_IO;
-    };
-    return context->write_fn(context->user, buffer); 
+    svg_real_t value[3] = {center->x, center->y, radius};
+    svg_real_t scaled[3];
+    svg_scale_reals(scaled, value, 3, context->precision);
+    return svg_write_circle(context, scaled, value, s); 
+}
+
+/**
+ * @brief Draws a batch of circle elements in the SVG.
+ *
+ * @param context Pointer to the SVG context
+ * @param cx      Array of count center x coordinates
+ * @param cy      Array of count center y coordinates
+ * @param radius  Array of count radii
+ * @param count   Number of circles
+ * @param style   Optional CSS style string shared by all circles (can be NULL)
+ *
+ * @return SVG_OK on success, SVG_ERR_NULL if context or any array is NULL,
+ *         or SVG_ERR_IO if writing fails
+ */
+svg_return_t svg_circles(svg_context_ptr context, const svg_coord_t *cx, const svg_coord_t *cy, const svg_real_t *radius, size_t count, const char *style){
+
+    if (!context || (count && (!cx || !cy || !radius))) {
+        return SVG_ERR_NULL;
+    }
+    const char* s = style ? style : "";
+    const svg_real_t *columns[3] = {cx, cy, radius};
+    return svg_write_batch(context, svg_write_circle, columns, 3, count, s);
 }
 
 
@@ -130,13 +503,35 @@ svg_return_t svg_rect(svg_context_ptr context, const svg_point_t *top_left, cons
     if (!context || !top_left || !size) {
         return SVG_ERR_NULL;
     }
-    char buffer[256];
     const char* s = style ? style : "";
-    int n = snprintf(buffer, sizeof(buffer), "<rect x=\"%f\" y=\"%f\" width=\"%f\" height=\"%f\" style=\"%s\"/>\n", top_left->x, top_left->y, size->width, size->height, s);
-    if (n < 0 || n >= (int)sizeof(buffer)) {
-        return SVG_ERR_IO;
+    svg_real_t value[4] = {top_left->x, top_left->y, size->width, size->height};
+    svg_real_t scaled[4];
+    svg_scale_reals(scaled, value, 4, context->precision);
+    return svg_write_rect(context, scaled, value, s); 
+}
+
+/**
+ * @brief Draws a batch of rectangle elements in the SVG.
+ *
+ * @param context Pointer to the SVG context
+ * @param x       Array of count top-left x coordinates
+ * @param y       Array of count top-left y coordinates
+ * @param width   Array of count widths
+ * @param height  Array of count heights
+ * @param count   Number of rectangles
+ * @param style   Optional CSS style string shared by all rectangles (can be NULL)
+ *
+ * @return SVG_OK on success, SVG_ERR_NULL if context or any array is NULL,
+ *         or SVG_ERR_IO if writing fails
+ */
+svg_return_t svg_rects(svg_context_ptr context, const svg_coord_t *x, const svg_coord_t *y, const svg_coord_t *width, const svg_coord_t *height, size_t count, const char *style){
+
+    if (!context || (count && (!x || !y || !width || !height))) {
+        return SVG_ERR_NULL;
     }
-    return context->write_fn(context->user, buffer); 
+    const char* s = style ? style : "";
+    const svg_real_t *columns[4] = {x, y, width, height};
+    return svg_write_batch(context, svg_write_rect, columns, 4, count, s);
 }
 
 /**
@@ -154,13 +549,470 @@ svg_return_t svg_line(svg_context_ptr context, const svg_point_t *start, const s
     if (!context || !start || !end) {
         return SVG_ERR_NULL;
     }
-    char buffer[256];
     const char* s = style ? style : "";
-    int n = snprintf(buffer, sizeof(buffer), "<line x1=\"%f\" y1=\"%f\" x2=\"%f\" y2=\"%f\" style=\"%s\"/>\n", start->x, start->y, end->x, end->y, s);
-    if (n < 0 || n >= (int)sizeof(buffer)) {
-        return SVG_ERR_IO;
+    svg_real_t value[4] = {start->x, start->y, end->x, end->y};
+    svg_real_t scaled[4];
+    svg_scale_reals(scaled, value, 4, context->precision);
+    return svg_write_line(context, scaled, value, s); 
+}
+
+/**
+ * @brief Draws a batch of line segments in the SVG.
+ *
+ * @param context Pointer to the SVG context
+ * @param x1      Array of count start x coordinates
+ * @param y1      Array of count start y coordinates
+ * @param x2      Array of count end x coordinates
+ * @param y2      Array of count end y coordinates
+ * @param count   Number of lines
+ * @param style   Optional CSS style string shared by all lines (can be NULL)
+ *
+ * @return SVG_OK on success, SVG_ERR_NULL if context or any array is NULL,
+ *         or SVG_ERR_IO if writing fails
+ */
+svg_return_t svg_lines(svg_context_ptr context, const svg_coord_t *x1, const svg_coord_t *y1, const svg_coord_t *x2, const svg_coord_t *y2, size_t count, const char *style){
+    if (!context || (count && (!x1 || !y1 || !x2 || !y2))) {
+        return SVG_ERR_NULL;
+    }
+    const char* s = style ? style : "";
+    const svg_real_t *columns[4] = {x1, y1, x2, y2};
+    return svg_write_batch(context, svg_write_line, columns, 4, count, s);
+}
+
+/**
+ * @brief Streaming state of per-column min/max decimation.
+ *
+ * Only indices into the input are kept, so the working set is fixed no
+ * matter how many points fall into a column.
+ */
+typedef struct{
+    svg_real_t column;  /**< Pixel column of the current points */
+    size_t first;       /**< Index of the first point in the column */
+    size_t low;         /**< Index of the lowest y in the column */
+    size_t high;        /**< Index of the highest y in the column */
+    size_t last;        /**< Index of the last point in the column */
+} svg_minmax_t;
+
+/**
+ * @brief Passes the distinct extreme points of a column on in input order.
+ *
+ * @param points   Input points
+ * @param state    Column to pass on
+ * @param point_fn Callback receiving the points
+ * @param user     User context passed to point_fn
+ *
+ * @return SVG_OK on success, or the first error returned by point_fn
+ */
+static svg_return_t svg_minmax_flush(const svg_point_t *points, const svg_minmax_t *state, svg_point_fn point_fn, svg_user_context_ptr user){
+    size_t order[4] = {state->first, state->low, state->high, state->last};
+    for (size_t index = 1; index < 4; index++) {
+        size_t value = order[index];
+        size_t position = index;
+        while (position && order[position - 1] > value) {
+            order[position] = order[position - 1];
+            position--;
+        }
+        order[position] = value;
     }
-    return context->write_fn(context->user, buffer); 
+    for (size_t index = 0; index < 4; index++) {
+        if (index && order[index] == order[index - 1]) {
+            continue;
+        }
+        svg_return_t ret = point_fn(user, points + order[index]);
+        if (ret != SVG_OK) {
+            return ret;
+        }
+    }
+    return SVG_OK;
+}
+
+/**
+ * @brief Decimates a polyline to at most four points per pixel column.
+ *
+ * Keeping the first, last, lowest and highest point of every column draws
+ * the same pixels as the full polyline when x is increasing.
+ *
+ * @param points   Input points
+ * @param count    Number of points
+ * @param point_fn Callback receiving the kept points
+ * @param user     User context passed to point_fn
+ *
+ * @return SVG_OK on success, or the first error returned by point_fn
+ */
+static svg_return_t svg_decimate_minmax(const svg_point_t *points, size_t count, svg_point_fn point_fn, svg_user_context_ptr user){
+    svg_minmax_t state = {0, 0, 0, 0, 0};
+    for (size_t index = 0; index < count; index++) {
+        svg_real_t column = floor(points[index].x);
+        if (index && column == state.column) {
+            if (points[index].y < points[state.low].y) {
+                state.low = index;
+            }
+            if (points[index].y > points[state.high].y) {
+                state.high = index;
+            }
+            state.last = index;
+            continue;
+        }
+        if (index) {
+            svg_return_t ret = svg_minmax_flush(points, &state, point_fn, user);
+            if (ret != SVG_OK) {
+                return ret;
+            }
+        }
+        state.column = column;
+        state.first = state.low = state.high = state.last = index;
+    }
+    return count ? svg_minmax_flush(points, &state, point_fn, user) : SVG_OK;
+}
+
+/**
+ * @brief Decimates a polyline with largest-triangle-three-buckets.
+ *
+ * The inner points are split into threshold - 2 buckets and the point of
+ * each bucket forming the largest triangle with the previous choice and the
+ * average of the next bucket is kept, along with the first and last points.
+ *
+ * @param points    Input points
+ * @param count     Number of points
+ * @param threshold Number of points to keep
+ * @param point_fn  Callback receiving the kept points
+ * @param user      User context passed to point_fn
+ *
+ * @return SVG_OK on success, or the first error returned by point_fn
+ */
+static svg_return_t svg_decimate_lttb(const svg_point_t *points, size_t count, size_t threshold, svg_point_fn point_fn, svg_user_context_ptr user){
+    if (threshold < 3 || threshold >= count) {
+        for (size_t index = 0; index < count; index++) {
+            svg_return_t ret = point_fn(user, points + index);
+            if (ret != SVG_OK) {
+                return ret;
+            }
+        }
+        return SVG_OK;
+    }
+    svg_real_t every = (svg_real_t)(count - 2) / (svg_real_t)(threshold - 2);
+    size_t previous = 0;
+    svg_return_t ret = point_fn(user, points);
+    for (size_t bucket = 0; bucket + 2 < threshold && ret == SVG_OK; bucket++) {
+        size_t start = (size_t)(bucket * every) + 1;
+        size_t end = (size_t)((bucket + 1) * every) + 1;
+        size_t next_end = (size_t)((bucket + 2) * every) + 1;
+        if (end > count - 1) {
+            end = count - 1;
+        }
+        if (next_end > count || bucket + 3 == threshold) {
+            next_end = count;
+        }
+        svg_real_t average_x = 0, average_y = 0;
+        for (size_t index = end; index < next_end; index++) {
+            average_x += points[index].x;
+            average_y += points[index].y;
+        }
+        average_x /= (svg_real_t)(next_end - end);
+        average_y /= (svg_real_t)(next_end - end);
+        size_t chosen = start;
+        svg_real_t largest = -1;
+        for (size_t index = start; index < end; index++) {
+            svg_real_t area = fabs((points[previous].x - average_x) * (points[index].y - points[previous].y) - (points[previous].x - points[index].x) * (average_y - points[previous].y));
+            if (area > largest) {
+                largest = area;
+                chosen = index;
+            }
+        }
+        ret = point_fn(user, points + chosen);
+        previous = chosen;
+    }
+    return ret == SVG_OK ? point_fn(user, points + count - 1) : ret;
+}
+
+/**
+ * @brief Sets the polyline decimation mode of the context.
+ *
+ * @param context Pointer to the SVG context
+ * @param mode    Decimation applied by svg_decimate() and svg_path()
+ *
+ * @return SVG_OK on success, SVG_ERR_NULL if context is NULL,
+ *         or SVG_ERR_INVALID_ARG if mode is unknown
+ */
+svg_return_t svg_set_decimation(svg_context_ptr context, svg_decimate_t mode){
+    if (!context) {
+        return SVG_ERR_NULL;
+    }
+    if (mode != SVG_DECIMATE_NONE && mode != SVG_DECIMATE_MINMAX && mode != SVG_DECIMATE_LTTB) {
+        return SVG_ERR_INVALID_ARG;
+    }
+    context->decimation = mode;
+    return SVG_OK;
+}
+
+/**
+ * @brief Streams the points of a polyline kept by the context decimation.
+ *
+ * Runs in one pass over the input using a fixed amount of working memory.
+ * LTTB keeps two points per pixel of canvas width.
+ *
+ * @param context  Pointer to the SVG context
+ * @param points   Array of count points
+ * @param count    Number of points
+ * @param point_fn Callback receiving the kept points in order
+ * @param user     User context passed to point_fn
+ *
+ * @return SVG_OK on success, SVG_ERR_NULL if context, points or point_fn is
+ *         NULL, or the first error returned by point_fn
+ */
+svg_return_t svg_decimate(svg_context_ptr context, const svg_point_t *points, size_t count, svg_point_fn point_fn, svg_user_context_ptr user){
+    if (!context || (count && !points) || !point_fn) {
+        return SVG_ERR_NULL;
+    }
+    switch (context->decimation) {
+        case SVG_DECIMATE_MINMAX:
+            return svg_decimate_minmax(points, count, point_fn, user);
+        case SVG_DECIMATE_LTTB:
+            return svg_decimate_lttb(points, count, 2 * (size_t)context->width, point_fn, user);
+        default:
+            return svg_decimate_lttb(points, count, count, point_fn, user);
+    }
+}
+
+/**
+ * @brief State of a path while svg_path() formats its d attribute.
+ *
+ * Points arrive one at a time from svg_decimate(). Each is held back until
+ * its successor is known, and the points dropped since the last one written
+ * are summarised by a sleeve: the range of directions from the last point
+ * that pass within tolerance of all of them, and the farthest of them.
+ */
+typedef struct{
+    svg_context_ptr context;
+    char block[SVG_PATH_BLOCK];  /**< Formatted text not yet emitted */
+    size_t length;               /**< Length of the text in block */
+    int relative;
+    int precision;
+    svg_real_t tolerance;
+    svg_real_t previous_x;       /**< Previous x, rounded for fixed precision */
+    svg_real_t previous_y;       /**< Previous y, rounded for fixed precision */
+    size_t written;              /**< Number of points written */
+    svg_point_t last;            /**< Last point written */
+    svg_point_t pending;         /**< Point waiting for its successor */
+    int has_pending;
+    svg_point_t direction;       /**< Direction the sleeve angles are measured from */
+    svg_real_t low;              /**< Lowest allowed angle from direction */
+    svg_real_t high;             /**< Highest allowed angle from direction */
+    svg_real_t reach;            /**< Farthest dropped point from last, 0 if none constrain */
+} svg_path_state_t;
+
+/**
+ * @brief Decides whether svg_path() keeps the pending point.
+ *
+ * The pending point may only be dropped if the segment from the last point
+ * kept to the next point passes within tolerance of it and of every point
+ * dropped before it. Each dropped point farther than tolerance from the last
+ * point kept narrows the sleeve of allowed directions, and the segment must
+ * reach at least as far as the farthest of them, so the check needs no more
+ * memory however many points are dropped. The sleeve is updated when the
+ * pending point is dropped.
+ *
+ * @param state Path being formatted
+ * @param next  Point after the pending one
+ *
+ * @return Non-zero if the pending point is kept
+ */
+static int svg_path_keep(svg_path_state_t *state, const svg_point_t *next){
+    const svg_point_t *last = &state->last;
+    svg_real_t tolerance = state->tolerance;
+    svg_real_t dx = state->pending.x - last->x;
+    svg_real_t dy = state->pending.y - last->y;
+    svg_real_t distance = sqrt(dx * dx + dy * dy);
+    svg_point_t direction = state->direction;
+    svg_real_t low = state->low, high = state->high, reach = state->reach;
+    // Points within tolerance of the last point are near any segment from it
+    if (distance > tolerance) {
+        svg_real_t spread = asin(tolerance / distance);
+        if (reach == 0) {
+            direction.x = dx;
+            direction.y = dy;
+            low = -spread;
+            high = spread;
+        }
+        else {
+            svg_real_t angle = atan2(direction.x * dy - direction.y * dx, direction.x * dx + direction.y * dy);
+            low = fmax(low, angle - spread);
+            high = fmin(high, angle + spread);
+        }
+        reach = fmax(reach, distance);
+    }
+    if (reach > 0) {
+        svg_real_t nx = next->x - last->x;
+        svg_real_t ny = next->y - last->y;
+        svg_real_t angle = atan2(direction.x * ny - direction.y * nx, direction.x * nx + direction.y * ny);
+        // Spikes fail the reach, so they are kept
+        if (low > high || angle < low || angle > high || sqrt(nx * nx + ny * ny) < reach) {
+            return 1;
+        }
+    }
+    state->direction = direction;
+    state->low = low;
+    state->high = high;
+    state->reach = reach;
+    return 0;
+}
+
+/**
+ * @brief Formats one path coordinate.
+ *
+ * Fixed precision values are rounded to integers in units of the last
+ * decimal place so that relative output can difference them exactly.
+ *
+ * @param buffer    Output buffer of at least SVG_NUMBER_BUFFER_SIZE bytes
+ * @param value     Coordinate to format
+ * @param previous  Previous coordinate in the same units, updated to value
+ * @param relative  Non-zero to format the difference from previous
+ * @param precision SVG_PRECISION_SHORTEST, or number of decimal places
+ *
+ * @return Number of characters written
+ */
+static size_t svg_path_number(char *buffer, svg_real_t value, svg_real_t *previous, int relative, int precision){
+    if (precision < 0 || !isfinite(value)) {
+        svg_real_t delta = relative ? value - *previous : value;
+        // Following the value a reader reconstructs keeps the error bounded
+        *previous = relative ? *previous + delta : value;
+        return svg_format_real(buffer, delta, SVG_PRECISION_SHORTEST);
+    }
+    svg_real_t scaled;
+    svg_scale_reals(&scaled, &value, 1, precision);
+    scaled = scaled < 0 ? -floor(0.5 - scaled) : floor(scaled + 0.5);
+    if (!relative) {
+        *previous = scaled;
+        return svg_format_scaled(buffer, scaled, value, precision);
+    }
+    svg_real_t delta = scaled - *previous;
+    *previous = scaled;
+    return svg_format_scaled(buffer, delta, delta / pow(10.0, precision), precision);
+}
+
+/**
+ * @brief Appends a point to the d attribute, emitting the block when full.
+ *
+ * @param state Path being formatted
+ * @param point Point to append
+ *
+ * @return SVG_OK on success, or the write callback's error code
+ */
+static svg_return_t svg_path_write(svg_path_state_t *state, const svg_point_t *point){
+    char *block = state->block;
+    size_t length = state->length;
+    int relative = state->relative && state->written;
+    // The first point after the move starts the line command
+    if (state->written == 1) {
+        block[length++] = state->relative ? 'l' : 'L';
+    }
+    else if (state->written) {
+        block[length++] = ' ';
+    }
+    char x[SVG_NUMBER_BUFFER_SIZE], y[SVG_NUMBER_BUFFER_SIZE];
+    size_t x_length = svg_path_number(x, point->x, &state->previous_x, relative, state->precision);
+    size_t y_length = svg_path_number(y, point->y, &state->previous_y, relative, state->precision);
+    if (x[0] == '-' && length && block[length - 1] == ' ') {
+        length--;
+    }
+    memcpy(block + length, x, x_length);
+    length += x_length;
+    if (y[0] != '-') {
+        block[length++] = ' ';
+    }
+    memcpy(block + length, y, y_length);
+    length += y_length;
+    state->last = *point;
+    state->reach = 0;
+    state->written++;
+    state->length = length;
+    if (length + 2 * SVG_NUMBER_BUFFER_SIZE + 2 >= SVG_PATH_BLOCK) {
+        block[length] = '\0';
+        state->length = 0;
+        return svg_emit(state->context, block, length);
+    }
+    return SVG_OK;
+}
+
+/**
+ * @brief Receives the next point of a path from svg_decimate().
+ *
+ * @param user  Path being formatted
+ * @param point Next point
+ *
+ * @return SVG_OK on success, or the write callback's error code
+ */
+static svg_return_t svg_path_point(svg_user_context_ptr user, const svg_point_t *point){
+    svg_path_state_t *state = (svg_path_state_t *)user;
+    svg_return_t ret = SVG_OK;
+    if (state->has_pending && (!state->written || state->tolerance <= 0 || svg_path_keep(state, point))) {
+        ret = svg_path_write(state, &state->pending);
+    }
+    state->pending = *point;
+    state->has_pending = 1;
+    return ret;
+}
+
+/**
+ * @brief Draws a polyline as a single path element.
+ *
+ * The points pass through the context decimation, and the d attribute is
+ * formatted into a local block that is emitted whenever it fills, so paths
+ * of any length go through the context output buffer.
+ *
+ * @param context Pointer to the SVG context
+ * @param points  Array of count points
+ * @param count   Number of points, at least 2
+ * @param options Encoding options, or NULL for the defaults
+ * @param style   Optional CSS style string (can be NULL)
+ *
+ * @return SVG_OK on success, SVG_ERR_NULL if context or points is NULL,
+ *         SVG_ERR_INVALID_ARG if count is below 2 or the precision is out
+ *         of range, or SVG_ERR_IO if writing fails
+ */
+svg_return_t svg_path(svg_context_ptr context, const svg_point_t *points, size_t count, const svg_path_options_t *options, const char *style){
+    if (!context || !points) {
+        return SVG_ERR_NULL;
+    }
+    svg_path_state_t state;
+    state.context = context;
+    state.length = 0;
+    state.relative = options ? options->relative : 0;
+    state.tolerance = options ? options->tolerance : 0;
+    state.precision = options ? options->precision : context->precision;
+    state.previous_x = state.previous_y = 0;
+    state.written = 0;
+    state.has_pending = 0;
+    state.reach = 0;
+    if (count < 2 || (state.precision != SVG_PRECISION_SHORTEST && (state.precision < 0 || state.precision > SVG_PRECISION_MAX))) {
+        return SVG_ERR_INVALID_ARG;
+    }
+    const char *head = "<path d=\"M";
+    svg_return_t ret = svg_emit(context, head, strlen(head));
+    if (ret == SVG_OK) {
+        ret = svg_decimate(context, points, count, svg_path_point, &state);
+    }
+    // The last point is always kept
+    if (ret == SVG_OK) {
+        ret = svg_path_write(&state, &state.pending);
+    }
+    if (ret == SVG_OK && state.length) {
+        state.block[state.length] = '\0';
+        ret = svg_emit(context, state.block, state.length);
+    }
+    const char *s = style ? style : "";
+    const char *middle = "\" style=\"";
+    const char *tail = "\"/>\n";
+    if (ret == SVG_OK) {
+        ret = svg_emit(context, middle, strlen(middle));
+    }
+    if (ret == SVG_OK) {
+        ret = svg_emit(context, s, strlen(s));
+    }
+    if (ret == SVG_OK) {
+        ret = svg_emit(context, tail, strlen(tail));
+    }
+    return ret == SVG_OK ? svg_end_element(context) : ret;
 }
 
 /**
@@ -180,13 +1032,15 @@ svg_return_t svg_group_begin(svg_context_ptr context, const char* attrs){
     if (!context) {
         return SVG_ERR_NULL;
     }
-    char buffer[256];
     const char* s = attrs ? attrs : "";
-    int n = snprintf(buffer, sizeof(buffer), "<g %s>\n", s);
-    if (n < 0 || n >= (int)sizeof(buffer)) {
-        return SVG_ERR_IO;
+    svg_return_t ret = svg_emit(context, "<g ", 3);
+    if (ret == SVG_OK) {
+        ret = svg_emit(context, s, strlen(s));
+    }
+    if (ret == SVG_OK) {
+        ret = svg_emit(context, ">\n", 2);
     }
-    return context->write_fn(context->user, buffer); 
+    return ret == SVG_OK ? svg_end_element(context) : ret; 
 }
 
 /**
@@ -204,5 +1058,6 @@ svg_return_t svg_group_end(svg_context_ptr context){
         return SVG_ERR_NULL;
     }
     const char* buffer = "</g>\n";
-    return context->write_fn(context->user, buffer); 
+    svg_return_t ret = svg_emit(context, buffer, strlen(buffer));
+    return ret == SVG_OK ? svg_end_element(context) : ret; 
 } 
@@ -0,0 +1,181 @@
+/**
+ * @file svg_number.c
+ * @brief Implementation of fast number formatting for SVG output.
+ *
+ * Values are scaled by a power of ten and rounded to a 64-bit integer whose
+ * digits are emitted directly. Because both the scaled integer (below 2^53)
+ * and the power of ten (up to 10^22) are exact doubles, the division used to
+ * check the round-trip is correctly rounded and matches what a parser reads
+ * back. Values outside that range take a slower printf-based path.
+ */
+#include "svg_number.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Largest integer that is exactly representable in a double.
+ */
+#define SVG_EXACT_INTEGER_LIMIT 9007199254740992.0
+
+/**
+ * @brief Powers of ten that are exactly representable in a double.
+ */
+static const double svg_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * @brief Writes a scaled integer as a decimal number.
+ *
+ * Emits scaled / 10^decimals, dropping trailing fractional zeros.
+ *
+ * @param buffer   Output buffer
+ * @param negative Non-zero if a minus sign is required
+ * @param scaled   Absolute value scaled by 10^decimals
+ * @param decimals Number of implied decimal places in scaled
+ *
+ * @return Number of characters written
+ */
+static size_t svg_emit_scaled(char *buffer, int negative, uint64_t scaled, int decimals){
+    char digits[24];
+    size_t count = 0;
+    size_t length = 0;
+
+    while (decimals > 0 && scaled % 10 == 0) {
+        scaled /= 10;
+        decimals--;
+    }
+    if (!scaled) {
+        buffer[0] = '0';
+        buffer[1] = '\0';
+        return 1;
+    }
+    do {
+        digits[count++] = (char)('0' + scaled % 10);
+        scaled /= 10;
+    } while (scaled);
+    while (count < (size_t)decimals + 1) {
+        digits[count++] = '0';
+    }
+    if (negative) {
+        buffer[length++] = '-';
+    }
+    while (count > (size_t)decimals) {
+        buffer[length++] = digits[--count];
+    }
+    if (count) {
+        buffer[length++] = '.';
+        while (count) {
+            buffer[length++] = digits[--count];
+        }
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Formats values outside the fast path range.
+ *
+ * Uses the fewest significant digits that round-trip through strtod.
+ *
+ * @param buffer Output buffer of at least SVG_NUMBER_BUFFER_SIZE bytes
+ * @param value  Value to format
+ *
+ * @return Number of characters written
+ */
+static size_t svg_format_slow(char *buffer, svg_real_t value){
+    int n = 0;
+    for (int digits = 1; digits <= 17; digits++) {
+        n = snprintf(buffer, SVG_NUMBER_BUFFER_SIZE, "%.*g", digits, value);
+        if (strtod(buffer, NULL) == value) {
+            break;
+        }
+    }
+    return n < 0 ? 0 : (size_t)n;
+}
+
+/**
+ * @brief Formats a real number as SVG text.
+ *
+ * @param buffer    Output buffer of at least SVG_NUMBER_BUFFER_SIZE bytes
+ * @param value     Value to format
+ * @param precision SVG_PRECISION_SHORTEST, or number of decimal places
+ *
+ * @return Number of characters written, not counting the null terminator
+ */
+size_t svg_format_real(char *buffer, svg_real_t value, int precision){
+    if (precision > SVG_PRECISION_MAX) {
+        precision = SVG_PRECISION_MAX;
+    }
+    if (precision >= 0) {
+        return svg_format_scaled(buffer, value * svg_pow10[precision], value, precision);
+    }
+    return svg_format_scaled(buffer, value, value, precision);
+}
+
+/**
+ * @brief Scales an array of values for fixed-precision formatting.
+ *
+ * @param scaled    Output array of count scaled values
+ * @param values    Input array of count values
+ * @param count     Number of values
+ * @param precision SVG_PRECISION_SHORTEST, or number of decimal places
+ */
+void svg_scale_reals(svg_real_t *scaled, const svg_real_t *values, size_t count, int precision){
+    svg_real_t factor = 1.0;
+    if (precision > SVG_PRECISION_MAX) {
+        precision = SVG_PRECISION_MAX;
+    }
+    if (precision >= 0) {
+        factor = svg_pow10[precision];
+    }
+    for (size_t index = 0; index < count; index++) {
+        scaled[index] = values[index] * factor;
+    }
+}
+
+/**
+ * @brief Formats a value prepared by svg_scale_reals().
+ *
+ * @param buffer    Output buffer of at least SVG_NUMBER_BUFFER_SIZE bytes
+ * @param scaled    Value scaled by 10^precision
+ * @param value     Original unscaled value
+ * @param precision SVG_PRECISION_SHORTEST, or number of decimal places
+ *
+ * @return Number of characters written, not counting the null terminator
+ */
+size_t svg_format_scaled(char *buffer, svg_real_t scaled, svg_real_t value, int precision){
+    int negative = value < 0;
+    svg_real_t magnitude = negative ? -value : value;
+
+    if (!isfinite(value)) {
+        return svg_format_slow(buffer, value);
+    }
+    if (precision > SVG_PRECISION_MAX) {
+        precision = SVG_PRECISION_MAX;
+    }
+    if (precision >= 0) {
+        if (negative) {
+            scaled = -scaled;
+        }
+        if (scaled < SVG_EXACT_INTEGER_LIMIT) {
+            uint64_t rounded = (uint64_t)(scaled + 0.5);
+            return svg_emit_scaled(buffer, negative && rounded, rounded, precision);
+        }
+        return svg_format_slow(buffer, value);
+    }
+    for (int decimals = 0; decimals <= 17; decimals++) {
+        svg_real_t scaled = magnitude * svg_pow10[decimals];
+        if (scaled >= SVG_EXACT_INTEGER_LIMIT) {
+            break;
+        }
+        uint64_t rounded = (uint64_t)nearbyint(scaled);
+        if ((svg_real_t)rounded / svg_pow10[decimals] == magnitude) {
+            return svg_emit_scaled(buffer, negative && rounded, rounded, decimals);
+        }
+    }
+    return svg_format_slow(buffer, value);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "DecompressingDataSource.h"
+#include "GzipDataSink.h"
+#include "StringDataSink.h"
+#include "StringDataSource.h"
+#include "XMLReader.h"
+
+std::string Gzip(const std::string &text, std::size_t buffersize = CGzipDataSink::DefaultBufferSize){
+    std::shared_ptr<CStringDataSink> Output = std::make_shared<CStringDataSink>();
+    CGzipDataSink Sink(Output, CGzipDataSink::DefaultLevel, buffersize);
+    Sink.Write(text.data(), text.size());
+    Sink.Close();
+    return Output->String();
+}
+
+std::string SampleText(std::size_t length){
+    std::string Text;
+    for(std::size_t Index = 0; Text.size() < length; Index++){
+        Text += "<rect x=\"" + std::to_string(Index * 7 % 1000) + "\" y=\"1\" width=\"2\" height=\"3\"/>\n";
+    }
+    Text.resize(length);
+    return Text;
+}
+
+std::string ReadAll(CDataSource &source, std::size_t chunk){
+    std::string Result;
+    std::vector<char> Buffer(chunk);
+    while(std::size_t Count = source.Read(Buffer.data(), Buffer.size())){
+        Result.append(Buffer.data(), Count);
+    }
+    return Result;
+}
+
+TEST(DecompressingDataSource, GzipTest){
+    std::string Text = SampleText(200000);
+    std::string Compressed = Gzip(Text);
+    for(bool Prefetch : {false, true}){
+        for(std::size_t BlockSize : {1, 7, 4096, 1 << 20}){
+            CDecompressingDataSource Source(std::make_shared<CStringDataSource>(Compressed), BlockSize, Prefetch);
+            char Ch;
+
+            EXPECT_EQ(Source.Format(), CDecompressingDataSource::EFormat::Gzip);
+            EXPECT_FALSE(Source.End());
+            EXPECT_TRUE(Source.Peek(Ch));
+            EXPECT_EQ(Ch, '<');
+            EXPECT_TRUE(Source.Get(Ch));
+            EXPECT_EQ(Ch, '<');
+            std::vector<char> Vector;
+            EXPECT_TRUE(Source.Read(Vector, 4));
+            EXPECT_EQ(std::string(Vector.begin(), Vector.end()), "rect");
+            EXPECT_EQ(ReadAll(Source, 1000), Text.substr(5));
+            EXPECT_TRUE(Source.End());
+            EXPECT_TRUE(Source.Valid());
+            EXPECT_FALSE(Source.Get(Ch));
+            EXPECT_FALSE(Source.Peek(Ch));
+            EXPECT_FALSE(Source.Read(Vector, 4));
+        }
+    }
+}
+
+TEST(DecompressingDataSource, RawTest){
+    for(std::string Text : {std::string(""), std::string("<"), SampleText(10000)}){
+        for(bool Prefetch : {false, true}){
+            CDecompressingDataSource Source(std::make_shared<CStringDataSource>(Text), 100, Prefetch);
+            EXPECT_EQ(Source.Format(), CDecompressingDataSource::EFormat::Raw);
+            EXPECT_EQ(Source.End(), Text.empty());
+            EXPECT_EQ(ReadAll(Source, 33), Text);
+            EXPECT_TRUE(Source.Valid());
+        }
+    }
+}
+
+TEST(DecompressingDataSource, MultipleMemberTest){
+    std::string First = SampleText(5000), Second = "<!-- appended -->\n";
+    CDecompressingDataSource Source(std::make_shared<CStringDataSource>(Gzip(First) + Gzip(Second)), 512);
+    EXPECT_EQ(ReadAll(Source, 100), First + Second);
+    EXPECT_TRUE(Source.Valid());
+}
+
+TEST(DecompressingDataSource, ErrorTest){
+    std::string Text = SampleText(100000);
+    std::string Compressed = Gzip(Text);
+    for(bool Prefetch : {false, true}){
+        std::string Truncated = Compressed.substr(0, Compressed.size() / 2);
+        CDecompressingDataSource TruncatedSource(std::make_shared<CStringDataSource>(Truncated), 1024, Prefetch);
+        std::string Prefix = ReadAll(TruncatedSource, 100);
+        EXPECT_EQ(Prefix, Text.substr(0, Prefix.size()));
+        EXPECT_TRUE(TruncatedSource.End());
+        EXPECT_FALSE(TruncatedSource.Valid());
+
+        std::string Corrupt = Compressed;
+        for(std::size_t Index = 20; Index < 60; Index++){
+            Corrupt[Index] = (char)0xff;
+        }
+        CDecompressingDataSource CorruptSource(std::make_shared<CStringDataSource>(Corrupt), 1024, Prefetch);
+        ReadAll(CorruptSource, 100);
+        EXPECT_FALSE(CorruptSource.Valid());
+    }
+    CDecompressingDataSource NoSource(nullptr);
+    EXPECT_TRUE(NoSource.End());
+    EXPECT_FALSE(NoSource.Valid());
+}
+
+#ifndef SVG_HAVE_ZSTD
+TEST(DecompressingDataSource, UnsupportedZstdTest){
+    std::string Frame("\x28\xb5\x2f\xfd\x00\x00", 6);
+    CDecompressingDataSource Source(std::make_shared<CStringDataSource>(Frame));
+    EXPECT_EQ(Source.Format(), CDecompressingDataSource::EFormat::Zstd);
+    EXPECT_TRUE(Source.End());
+    EXPECT_FALSE(Source.Valid());
+}
+#endif
+
+TEST(DecompressingDataSource, XMLReaderTest){
+    std::string Document = "<svg width=\"10\" height=\"10\">\n";
+    for(int Index = 0; Index < 5000; Index++){
+        Document += "<circle cx=\"" + std::to_string(Index) + "\" cy=\"2\" r=\"1\"/>\n";
+    }
+    Document += "</svg>\n";
+    for(bool Prefetch : {false, true}){
+        auto Source = std::make_shared<CDecompressingDataSource>(std::make_shared<CStringDataSource>(Gzip(Document)), 4096, Prefetch);
+        CXMLReader Reader(Source, 1000);
+        SXMLEntity Entity;
+        std::size_t Circles = 0;
+        while(Reader.ReadEntity(Entity, true)){
+            Circles += Entity.DType == SXMLEntity::EType::StartElement && Entity.DNameData == "circle";
+        }
+        EXPECT_EQ(Circles, 5000);
+        EXPECT_TRUE(Source->Valid());
+    }
+}
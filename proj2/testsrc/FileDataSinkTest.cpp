@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "FileDataSink.h"
+#include "SVGWriter.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+// Creates a temporary file and removes it when the test finishes
+struct STempFile{
+    std::string DPath;
+    int DFileDescriptor;
+
+    STempFile(){
+        char Template[] = "/tmp/filedatasinktestXXXXXX";
+        DFileDescriptor = mkstemp(Template);
+        DPath = Template;
+    }
+
+    ~STempFile(){
+        if(DFileDescriptor >= 0){
+            close(DFileDescriptor);
+        }
+        unlink(DPath.c_str());
+    }
+
+    std::string Contents() const{
+        std::ifstream Input(DPath, std::ios::binary);
+        std::stringstream Stream;
+        Stream << Input.rdbuf();
+        return Stream.str();
+    }
+};
+
+TEST(FileDataSink, PutWriteTest){
+    STempFile File;
+    {
+        CFileDataSink Sink(File.DPath, 16);
+        std::vector<char> TempVector = {' ','W','o','r','l','d'};
+
+        EXPECT_TRUE(Sink.Valid());
+        EXPECT_TRUE(Sink.Put('H'));
+        EXPECT_TRUE(Sink.Write("ello", 4));
+        EXPECT_TRUE(Sink.Write(TempVector));
+        EXPECT_EQ(File.Contents(), "");
+        EXPECT_TRUE(Sink.Flush());
+        EXPECT_EQ(File.Contents(), "Hello World");
+    }
+    EXPECT_EQ(File.Contents(), "Hello World");
+}
+
+TEST(FileDataSink, LargeWriteTest){
+    std::string Text;
+    for(int Index = 0; Index < 10000; Index++){
+        Text += (char)('a' + Index % 26);
+    }
+    for(bool Vectored : {true, false}){
+        STempFile File;
+        {
+            CFileDataSink Sink(File.DPath, 100, Vectored);
+            EXPECT_TRUE(Sink.Write("<", 1));
+            EXPECT_TRUE(Sink.Write(Text.data(), Text.size()));
+            EXPECT_TRUE(Sink.Write(">", 1));
+            if(Vectored){
+                EXPECT_EQ(Sink.WriteCalls(), 1);
+            }
+            EXPECT_TRUE(Sink.Close());
+            EXPECT_FALSE(Sink.Put('x'));
+        }
+        EXPECT_EQ(File.Contents(), "<" + Text + ">");
+    }
+}
+
+TEST(FileDataSink, FileDescriptorTest){
+    STempFile File;
+    {
+        CFileDataSink Sink(File.DFileDescriptor);
+        EXPECT_TRUE(Sink.Write("Hello", 5));
+    }
+    EXPECT_EQ(File.Contents(), "Hello");
+    EXPECT_EQ(write(File.DFileDescriptor, "!", 1), 1);
+    EXPECT_EQ(File.Contents(), "Hello!");
+}
+
+TEST(FileDataSink, DirectTest){
+    STempFile File;
+    std::string Text;
+    for(int Index = 0; Index < 10000; Index++){
+        Text += (char)('0' + Index % 10);
+    }
+    {
+        CFileDataSink Sink(File.DPath, 5000, true, true);
+        EXPECT_TRUE(Sink.Valid());
+        EXPECT_TRUE(Sink.Write(Text.data(), Text.size()));
+        EXPECT_TRUE(Sink.Flush());
+        EXPECT_TRUE(Sink.Put('!'));
+    }
+    EXPECT_EQ(File.Contents(), Text + "!");
+}
+
+TEST(FileDataSink, ErrorTest){
+    CFileDataSink Missing(std::string("/nonexistent/directory/file.svg"));
+    EXPECT_FALSE(Missing.Valid());
+    EXPECT_FALSE(Missing.Put('x'));
+    EXPECT_FALSE(Missing.Flush());
+
+    CFileDataSink Closed(-1);
+    EXPECT_FALSE(Closed.Write("x", 1));
+}
+
+TEST(FileDataSink, SVGWriterTest){
+    STempFile File;
+    {
+        std::shared_ptr<CFileDataSink> Sink = std::make_shared<CFileDataSink>(File.DPath, 64);
+        CSVGWriter Writer(Sink, 100, 100);
+        EXPECT_TRUE(Writer.Circle({50, 50}, 25, {{"fill","red"}}));
+    }
+    std::string Contents = File.Contents();
+    EXPECT_NE(Contents.find("<circle cx=\"50\" cy=\"50\" r=\"25\" style=\"fill:red\"/>"), std::string::npos);
+    EXPECT_NE(Contents.find("</svg>\n"), std::string::npos);
+}
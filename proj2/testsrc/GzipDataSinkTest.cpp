@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "GzipDataSink.h"
+#include "StringDataSink.h"
+#include "SVGWriter.h"
+#include <zlib.h>
+
+// Sink that fails once more than DLimit bytes have been written
+class CFailingDataSink : public CDataSink{
+    public:
+        std::size_t DLimit;
+        std::size_t DWritten = 0;
+
+        CFailingDataSink(std::size_t limit) : DLimit(limit){
+
+        }
+
+        bool Put(const char &ch) noexcept override{
+            return Write(&ch, 1);
+        }
+
+        bool Write(const std::vector<char> &buf) noexcept override{
+            return Write(buf.data(), buf.size());
+        }
+
+        bool Write(const char *buf, std::size_t length) noexcept override{
+            DWritten += length;
+            return DWritten <= DLimit;
+        }
+};
+
+// Decompresses gzip data; finished is set when the gzip trailer was reached
+std::string Gunzip(const std::string &data, bool *finished = nullptr){
+    std::string Result;
+    z_stream Stream{};
+    char Buffer[4096];
+    inflateInit2(&Stream, 15 + 16);
+    Stream.next_in = (Bytef *)data.data();
+    Stream.avail_in = (uInt)data.size();
+    int Status;
+    do{
+        Stream.next_out = (Bytef *)Buffer;
+        Stream.avail_out = sizeof(Buffer);
+        Status = inflate(&Stream, Z_SYNC_FLUSH);
+        Result.append(Buffer, sizeof(Buffer) - Stream.avail_out);
+    }while(Status == Z_OK && (Stream.avail_in || !Stream.avail_out));
+    inflateEnd(&Stream);
+    if(finished){
+        *finished = Status == Z_STREAM_END;
+    }
+    return Result;
+}
+
+std::string RepetitiveText(std::size_t length){
+    std::string Text;
+    for(std::size_t Index = 0; Text.size() < length; Index++){
+        Text += "<circle cx=\"" + std::to_string(Index % 1000) + "\" cy=\"5\" r=\"2\" style=\"fill:blue\"/>\n";
+    }
+    Text.resize(length);
+    return Text;
+}
+
+TEST(GzipDataSink, RoundTripTest){
+    std::string Text = RepetitiveText(100000);
+    for(bool Threaded : {false, true}){
+        for(std::size_t BufferSize : {1, 7, 4096}){
+            std::shared_ptr<CStringDataSink> Output = std::make_shared<CStringDataSink>();
+            CGzipDataSink Sink(Output, CGzipDataSink::DefaultLevel, BufferSize, Threaded);
+            std::vector<char> Vector(Text.begin() + 1, Text.begin() + 10);
+
+            EXPECT_TRUE(Sink.Valid());
+            EXPECT_EQ(Sink.Threaded(), Threaded);
+            EXPECT_TRUE(Sink.Put(Text[0]));
+            EXPECT_TRUE(Sink.Write(Vector));
+            EXPECT_TRUE(Sink.Write(Text.data() + 10, 90));
+            EXPECT_TRUE(Sink.Write(Text.data() + 100, Text.size() - 100));
+            EXPECT_TRUE(Sink.Close());
+            EXPECT_TRUE(Sink.Close());
+            EXPECT_FALSE(Sink.Put('x'));
+
+            bool Finished = false;
+            std::string Compressed = Output->String();
+            ASSERT_GE(Compressed.size(), 2);
+            EXPECT_EQ((unsigned char)Compressed[0], 0x1f);
+            EXPECT_EQ((unsigned char)Compressed[1], 0x8b);
+            EXPECT_EQ(Gunzip(Compressed, &Finished), Text);
+            EXPECT_TRUE(Finished);
+            EXPECT_EQ(Sink.BytesIn(), Text.size());
+            EXPECT_EQ(Sink.BytesOut(), Compressed.size());
+            EXPECT_LT(Compressed.size(), Text.size() / 10);
+        }
+    }
+}
+
+TEST(GzipDataSink, FlushTest){
+    std::string Text = RepetitiveText(5000);
+    for(bool Threaded : {false, true}){
+        std::shared_ptr<CStringDataSink> Output = std::make_shared<CStringDataSink>();
+        {
+            CGzipDataSink Sink(Output, 9, 1 << 16, Threaded);
+            bool Finished = true;
+
+            EXPECT_TRUE(Sink.Write(Text.data(), Text.size()));
+            EXPECT_TRUE(Sink.Flush());
+            EXPECT_EQ(Gunzip(Output->String(), &Finished), Text);
+            EXPECT_FALSE(Finished);
+            EXPECT_TRUE(Sink.Write(Text.data(), 10));
+        }
+        bool Finished = false;
+        EXPECT_EQ(Gunzip(Output->String(), &Finished), Text + Text.substr(0, 10));
+        EXPECT_TRUE(Finished);
+    }
+}
+
+TEST(GzipDataSink, SVGWriterTest){
+    std::shared_ptr<CStringDataSink> Plain = std::make_shared<CStringDataSink>();
+    std::shared_ptr<CStringDataSink> Compressed = std::make_shared<CStringDataSink>();
+    for(auto Sink : {std::shared_ptr<CDataSink>(Plain), std::shared_ptr<CDataSink>(std::make_shared<CGzipDataSink>(Compressed, 1, 1024, true))}){
+        CSVGWriter Writer(Sink, 100, 100);
+        for(int Index = 0; Index < 1000; Index++){
+            EXPECT_TRUE(Writer.Circle({(TSVGReal)(Index % 100), 50}, 2, {{"fill","red"}}));
+        }
+    }
+    EXPECT_EQ(Gunzip(Compressed->String()), Plain->String());
+}
+
+TEST(GzipDataSink, ErrorTest){
+    std::string Text = RepetitiveText(100000);
+    for(bool Threaded : {false, true}){
+        CGzipDataSink Sink(std::make_shared<CFailingDataSink>(16), 0, 1024, Threaded);
+        bool Written = true;
+        for(std::size_t Offset = 0; Offset < Text.size() && Written; Offset += 1000){
+            Written = Sink.Write(Text.data() + Offset, 1000);
+        }
+        EXPECT_FALSE(Written && Sink.Flush());
+        EXPECT_FALSE(Sink.Close());
+        EXPECT_FALSE(Sink.Valid());
+    }
+
+    CGzipDataSink NoSink(nullptr);
+    CGzipDataSink BadLevel(std::make_shared<CStringDataSink>(), 10, 1024, true);
+    EXPECT_FALSE(NoSink.Valid());
+    EXPECT_FALSE(NoSink.Put('x'));
+    EXPECT_FALSE(BadLevel.Valid());
+    EXPECT_FALSE(BadLevel.Threaded());
+    EXPECT_FALSE(BadLevel.Flush());
+    EXPECT_FALSE(BadLevel.Close());
+}
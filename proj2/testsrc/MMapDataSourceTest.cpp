@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "MMapDataSource.h"
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+
+// Writes contents to a temporary file and removes it when the test finishes
+struct STempFile{
+    std::string DPath;
+
+    STempFile(const std::string &contents){
+        char Template[] = "/tmp/mmapdatasourcetestXXXXXX";
+        close(mkstemp(Template));
+        DPath = Template;
+        std::ofstream Output(DPath, std::ios::binary);
+        Output << contents;
+    }
+
+    ~STempFile(){
+        unlink(DPath.c_str());
+    }
+};
+
+TEST(MMapDataSource, EndTest){
+    STempFile EmptyFile("");
+    STempFile BaseFile("Hello");
+    CMMapDataSource EmptySource(EmptyFile.DPath);
+    CMMapDataSource BaseSource(BaseFile.DPath);
+
+    EXPECT_TRUE(EmptySource.Valid());
+    EXPECT_TRUE(EmptySource.End());
+    EXPECT_TRUE(BaseSource.Valid());
+    EXPECT_FALSE(BaseSource.End());
+}
+
+TEST(MMapDataSource, PeekGetTest){
+    STempFile File("Bye");
+    CMMapDataSource Source(File.DPath);
+    char TempCh = 'x';
+
+    EXPECT_TRUE(Source.Peek(TempCh));
+    EXPECT_EQ(TempCh,'B');
+    EXPECT_TRUE(Source.Get(TempCh));
+    EXPECT_EQ(TempCh,'B');
+    EXPECT_TRUE(Source.Peek(TempCh));
+    EXPECT_EQ(TempCh,'y');
+    EXPECT_TRUE(Source.Get(TempCh));
+    EXPECT_TRUE(Source.Get(TempCh));
+    EXPECT_EQ(TempCh,'e');
+    TempCh = 'x';
+    EXPECT_FALSE(Source.Get(TempCh));
+    EXPECT_FALSE(Source.Peek(TempCh));
+    EXPECT_EQ(TempCh,'x');
+    EXPECT_TRUE(Source.End());
+}
+
+TEST(MMapDataSource, ReadTest){
+    STempFile File("Hello");
+    CMMapDataSource Source(File.DPath);
+    std::vector< char > TempVector;
+    char TempCh = 'x';
+
+    EXPECT_TRUE(Source.Read(TempVector,4));
+    ASSERT_EQ(TempVector.size(),4);
+    EXPECT_EQ(std::string(TempVector.begin(),TempVector.end()),"Hell");
+    EXPECT_TRUE(Source.Peek(TempCh));
+    EXPECT_EQ(TempCh,'o');
+    EXPECT_TRUE(Source.Read(TempVector,4));
+    ASSERT_EQ(TempVector.size(),1);
+    EXPECT_EQ(TempVector[0],'o');
+    EXPECT_FALSE(Source.Read(TempVector,4));
+    EXPECT_TRUE(TempVector.empty());
+}
+
+TEST(MMapDataSource, RegionTest){
+    STempFile File("<svg></svg>");
+    CMMapDataSource Source(File.DPath);
+    char TempCh;
+
+    ASSERT_NE(Source.Data(),nullptr);
+    EXPECT_EQ(std::string(Source.Data(),Source.Size()),"<svg></svg>");
+    EXPECT_EQ(Source.Skip(5),5);
+    EXPECT_EQ(Source.Position(),5);
+    EXPECT_TRUE(Source.Get(TempCh));
+    EXPECT_EQ(TempCh,'<');
+    EXPECT_EQ(Source.Skip(100),5);
+    EXPECT_TRUE(Source.End());
+}
+
+TEST(MMapDataSource, MissingFileTest){
+    CMMapDataSource Source("/nonexistent/file.xml");
+    char TempCh;
+
+    EXPECT_FALSE(Source.Valid());
+    EXPECT_TRUE(Source.End());
+    EXPECT_FALSE(Source.Get(TempCh));
+}
+
+TEST(MMapDataSource, BulkReadTest){
+    STempFile File("Hello World");
+    CMMapDataSource Source(File.DPath);
+    char Buffer[8];
+
+    EXPECT_EQ(Source.Read(Buffer,5),5);
+    EXPECT_EQ(std::string(Buffer,5),"Hello");
+    EXPECT_EQ(Source.Read(Buffer,sizeof(Buffer)),6);
+    EXPECT_EQ(std::string(Buffer,6)," World");
+    EXPECT_EQ(Source.Read(Buffer,sizeof(Buffer)),0);
+}
@@ -0,0 +1,61 @@
+#include "svg_number.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+std::string Format(svg_real_t value, int precision = SVG_PRECISION_SHORTEST){
+    char Buffer[SVG_NUMBER_BUFFER_SIZE];
+    size_t Length = svg_format_real(Buffer, value, precision);
+    EXPECT_EQ(Length, std::string(Buffer).length());
+    return std::string(Buffer, Length);
+}
+
+TEST(SVGNumberTest, IntegerTest){
+    EXPECT_EQ(Format(0), "0");
+    EXPECT_EQ(Format(-0.0), "0");
+    EXPECT_EQ(Format(50), "50");
+    EXPECT_EQ(Format(-25), "-25");
+    EXPECT_EQ(Format(1000000), "1000000");
+}
+
+TEST(SVGNumberTest, ShortestTest){
+    EXPECT_EQ(Format(0.1), "0.1");
+    EXPECT_EQ(Format(2.5), "2.5");
+    EXPECT_EQ(Format(-0.05), "-0.05");
+    EXPECT_EQ(Format(123.456), "123.456");
+    EXPECT_EQ(Format(1.0/3.0), "0.3333333333333333");
+}
+
+TEST(SVGNumberTest, FixedTest){
+    EXPECT_EQ(Format(50, 2), "50");
+    EXPECT_EQ(Format(1.0/3.0, 2), "0.33");
+    EXPECT_EQ(Format(2.0/3.0, 0), "1");
+    EXPECT_EQ(Format(-2.0/3.0, 3), "-0.667");
+    EXPECT_EQ(Format(-0.0001, 2), "0");
+    EXPECT_EQ(Format(1.25, 1), "1.3");
+    EXPECT_EQ(Format(0.1, SVG_PRECISION_MAX + 5), "0.1");
+}
+
+TEST(SVGNumberTest, RoundTripTest){
+    std::srand(36);
+    for(int Index = 0; Index < 10000; Index++){
+        svg_real_t Value = (std::rand() - RAND_MAX / 2) / (svg_real_t)(std::rand() % 10000 + 1);
+        std::string Text = Format(Value);
+        EXPECT_EQ(std::strtod(Text.c_str(), nullptr), Value) << Text;
+    }
+}
+
+TEST(SVGNumberTest, SlowPathTest){
+    std::string Text = Format(1e-20);
+    EXPECT_EQ(std::strtod(Text.c_str(), nullptr), 1e-20);
+    EXPECT_EQ(Text, "1e-20");
+    Text = Format(1.5e300);
+    EXPECT_EQ(std::strtod(Text.c_str(), nullptr), 1.5e300);
+    Text = Format(-std::numeric_limits<svg_real_t>::max());
+    EXPECT_EQ(std::strtod(Text.c_str(), nullptr), -std::numeric_limits<svg_real_t>::max());
+    EXPECT_LT(Text.length(), SVG_NUMBER_BUFFER_SIZE);
+    Text = Format(1e20, 4);
+    EXPECT_EQ(std::strtod(Text.c_str(), nullptr), 1e20);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "SVGReader.h"
+#include "StringDataSource.h"
+#include <string>
+
+TEST(SVGReaderTest, ShapeTest){
+    CSVGReader Reader(std::make_shared<CStringDataSource>(
+        "<svg width=\"100\" height=\"50\">"
+        "<circle cx=\"10.5\" cy=\"-2\" r=\"3\" style=\"fill:red\"/>"
+        "<g><rect x=\"1\" y=\"2\" width=\"3e1\" height=\" 4 \"/></g>"
+        "<line x1=\"0\" y1=\"1\" x2=\"+2\" y2=\".5\" style=\"stroke:black\"/>"
+        "</svg>"));
+    SSVGShape Shape;
+
+    ASSERT_TRUE(Reader.ReadShape(Shape));
+    EXPECT_EQ(Shape.DType, SSVGShape::EType::Circle);
+    EXPECT_EQ(Shape.DPoint.DX, 10.5);
+    EXPECT_EQ(Shape.DPoint.DY, -2.0);
+    EXPECT_EQ(Shape.DRadius, 3.0);
+    EXPECT_EQ(Shape.DStyle, "fill:red");
+
+    ASSERT_TRUE(Reader.ReadShape(Shape));
+    EXPECT_EQ(Shape.DType, SSVGShape::EType::Rectangle);
+    EXPECT_EQ(Shape.DPoint.DX, 1.0);
+    EXPECT_EQ(Shape.DPoint.DY, 2.0);
+    EXPECT_EQ(Shape.DSize.DWidth, 30.0);
+    EXPECT_EQ(Shape.DSize.DHeight, 4.0);
+    EXPECT_TRUE(Shape.DStyle.empty());
+
+    ASSERT_TRUE(Reader.ReadShape(Shape));
+    EXPECT_EQ(Shape.DType, SSVGShape::EType::Line);
+    EXPECT_EQ(Shape.DPoint.DX, 0.0);
+    EXPECT_EQ(Shape.DPoint.DY, 1.0);
+    EXPECT_EQ(Shape.DEnd.DX, 2.0);
+    EXPECT_EQ(Shape.DEnd.DY, 0.5);
+    EXPECT_EQ(Shape.DStyle, "stroke:black");
+
+    EXPECT_FALSE(Reader.ReadShape(Shape));
+    EXPECT_TRUE(Reader.End());
+    EXPECT_EQ(Reader.SkippedShapes(), 0);
+}
+
+TEST(SVGReaderTest, DefaultTest){
+    CSVGReader Reader(std::make_shared<CStringDataSource>("<svg><circle r=\"5\"/></svg>"));
+    SSVGShape Shape;
+
+    ASSERT_TRUE(Reader.ReadShape(Shape));
+    EXPECT_EQ(Shape.DPoint.DX, 0.0);
+    EXPECT_EQ(Shape.DPoint.DY, 0.0);
+    EXPECT_EQ(Shape.DRadius, 5.0);
+    EXPECT_FALSE(Reader.ReadShape(Shape));
+}
+
+TEST(SVGReaderTest, MalformedTest){
+    CSVGReader Reader(std::make_shared<CStringDataSource>(
+        "<svg><circle cx=\"1px\" cy=\"2\" r=\"3\"/><rect width=\"\"/>"
+        "<line x1=\"nan\"/><circle cx=\"4\" r=\"1\"/></svg>"));
+    SSVGShape Shape;
+
+    ASSERT_TRUE(Reader.ReadShape(Shape));
+    EXPECT_EQ(Shape.DType, SSVGShape::EType::Circle);
+    EXPECT_EQ(Shape.DPoint.DX, 4.0);
+    EXPECT_FALSE(Reader.ReadShape(Shape));
+    EXPECT_EQ(Reader.SkippedShapes(), 3);
+}
+
+TEST(SVGReaderTest, ParallelTest){
+    std::string Document = "<svg>";
+    for(int Index = 0; Index < 4000; Index++){
+        Document += "<circle cx=\"" + std::to_string(Index) + "\" cy=\"1\" r=\"2\"/>";
+    }
+    Document += "</svg>";
+    for(std::size_t Threads : {1, 3}){
+        for(bool Fast : {false, true}){
+            CSVGReader Reader(std::make_shared<CStringDataSource>(Document), 1024, Threads, Fast);
+            SSVGShape Shape;
+            int Count = 0;
+            while(Reader.ReadShape(Shape)){
+                EXPECT_EQ(Shape.DPoint.DX, Count);
+                Count++;
+            }
+            EXPECT_EQ(Count, 4000);
+        }
+    }
+}
+
+TEST(SVGReaderTest, ElementTest){
+    CSVGReader Reader(std::make_shared<CStringDataSource>(
+        "<svg width=\"100\" height=\"50%\"><g id=\"a\" style=\"fill:none\"><circle r=\"1\"/></g></svg>"));
+    SSVGShape Shape;
+
+    ASSERT_TRUE(Reader.ReadElement(Shape));
+    EXPECT_EQ(Shape.DType, SSVGShape::EType::Document);
+    EXPECT_EQ(Shape.DSize.DWidth, 100.0);
+    EXPECT_EQ(Shape.DSize.DHeight, 0.0);
+    ASSERT_TRUE(Reader.ReadElement(Shape));
+    EXPECT_EQ(Shape.DType, SSVGShape::EType::GroupBegin);
+    EXPECT_EQ(Shape.DStyle, "fill:none");
+    EXPECT_EQ(Reader.Entity().AttributeValue("id"), "a");
+    ASSERT_TRUE(Reader.ReadElement(Shape));
+    EXPECT_EQ(Shape.DType, SSVGShape::EType::Circle);
+    ASSERT_TRUE(Reader.ReadElement(Shape));
+    EXPECT_EQ(Shape.DType, SSVGShape::EType::GroupEnd);
+    EXPECT_FALSE(Reader.ReadElement(Shape));
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "SVGScene.h"
+#include "StringDataSource.h"
+#include <string>
+
+TEST(SVGSceneTest, EmptyTest){
+    CSVGSceneLoader Loader;
+    SSVGScene Scene;
+
+    EXPECT_FALSE(Loader.Load(std::make_shared<CStringDataSource>("<g><circle r=\"1\"/></g>"), Scene));
+    EXPECT_TRUE(Loader.Load(std::make_shared<CStringDataSource>("<svg width=\"10\" height=\"20\"/>"), Scene));
+    EXPECT_EQ(Scene.DSize.DWidth, 10.0);
+    EXPECT_EQ(Scene.DSize.DHeight, 20.0);
+    EXPECT_EQ(Scene.ShapeCount(), 0);
+    ASSERT_EQ(Scene.DStyles.size(), 1);
+    EXPECT_EQ(Scene.DStyles[0], "");
+    EXPECT_TRUE(Scene.DRuns.empty());
+}
+
+TEST(SVGSceneTest, ShapeTest){
+    CSVGSceneLoader Loader;
+    SSVGScene Scene;
+
+    ASSERT_TRUE(Loader.Load(std::make_shared<CStringDataSource>(
+        "<svg width=\"100\" height=\"100\">"
+        "<circle cx=\"1\" cy=\"2\" r=\"3\" style=\"fill:red\"/>"
+        "<circle cx=\"4\" cy=\"5\" r=\"6\" style=\"fill:red\"/>"
+        "<circle cx=\"7\" cy=\"8\" r=\"9\"/>"
+        "<rect x=\"1\" y=\"2\" width=\"3\" height=\"4\" style=\"fill:red\"/>"
+        "<line x1=\"1\" y1=\"2\" x2=\"3\" y2=\"4\" style=\"stroke:blue\"/>"
+        "<circle cx=\"x\"/>"
+        "</svg>"), Scene));
+
+    ASSERT_EQ(Scene.DCircles.Size(), 3);
+    EXPECT_EQ(Scene.DCircles.DX, std::vector<TSVGCoordinate>({1, 4, 7}));
+    EXPECT_EQ(Scene.DCircles.DY, std::vector<TSVGCoordinate>({2, 5, 8}));
+    EXPECT_EQ(Scene.DCircles.DRadius, std::vector<TSVGReal>({3, 6, 9}));
+    ASSERT_EQ(Scene.DRectangles.Size(), 1);
+    EXPECT_EQ(Scene.DRectangles.DWidth[0], 3.0);
+    EXPECT_EQ(Scene.DRectangles.DHeight[0], 4.0);
+    ASSERT_EQ(Scene.DLines.Size(), 1);
+    EXPECT_EQ(Scene.DLines.DX2[0], 3.0);
+    EXPECT_EQ(Scene.DLines.DY2[0], 4.0);
+    EXPECT_EQ(Scene.ShapeCount(), 5);
+    EXPECT_EQ(Loader.SkippedShapes(), 1);
+
+    // Styles are shared by index
+    ASSERT_EQ(Scene.DStyles.size(), 3);
+    EXPECT_EQ(Scene.DStyles[Scene.DCircles.DStyle[0]], "fill:red");
+    EXPECT_EQ(Scene.DCircles.DStyle[1], Scene.DCircles.DStyle[0]);
+    EXPECT_EQ(Scene.DCircles.DStyle[2], 0);
+    EXPECT_EQ(Scene.DRectangles.DStyle[0], Scene.DCircles.DStyle[0]);
+    EXPECT_EQ(Scene.DStyles[Scene.DLines.DStyle[0]], "stroke:blue");
+
+    // Same type and style shapes share a run
+    ASSERT_EQ(Scene.DRuns.size(), 4);
+    EXPECT_EQ(Scene.DRuns[0].DType, SSVGShape::EType::Circle);
+    EXPECT_EQ(Scene.DRuns[0].DBegin, 0);
+    EXPECT_EQ(Scene.DRuns[0].DCount, 2);
+    EXPECT_EQ(Scene.DRuns[1].DType, SSVGShape::EType::Circle);
+    EXPECT_EQ(Scene.DRuns[1].DBegin, 2);
+    EXPECT_EQ(Scene.DRuns[1].DCount, 1);
+    EXPECT_EQ(Scene.DRuns[2].DType, SSVGShape::EType::Rectangle);
+    EXPECT_EQ(Scene.DRuns[3].DType, SSVGShape::EType::Line);
+    EXPECT_GT(Scene.MemoryUsage(), 0);
+}
+
+TEST(SVGSceneTest, GroupTest){
+    CSVGSceneLoader Loader;
+    SSVGScene Scene;
+
+    ASSERT_TRUE(Loader.Load(std::make_shared<CStringDataSource>(
+        "<svg>"
+        "<circle r=\"1\"/>"
+        "<g id=\"outer\"><circle r=\"2\"/><g id=\"inner\" style=\"fill:red\"/><circle r=\"3\"/></g>"
+        "<circle r=\"4\"/>"
+        "</svg>"), Scene));
+
+    ASSERT_EQ(Scene.DGroups.size(), 2);
+    const SSVGScene::SGroup &Outer = Scene.DGroups[0];
+    const SSVGScene::SGroup &Inner = Scene.DGroups[1];
+    EXPECT_EQ(Outer.DParent, SSVGScene::NoParent);
+    EXPECT_EQ(Inner.DParent, 0);
+    EXPECT_EQ(Outer.DAttributes, TAttributes({{"id", "outer"}}));
+    EXPECT_EQ(Inner.DAttributes, TAttributes({{"id", "inner"}, {"style", "fill:red"}}));
+
+    // circle, outer begin, circle, inner begin, inner end, circle, outer end, circle
+    ASSERT_EQ(Scene.DRuns.size(), 8);
+    EXPECT_EQ(Outer.DRunBegin, 1);
+    EXPECT_EQ(Outer.DRunEnd, 7);
+    EXPECT_EQ(Inner.DRunBegin, 3);
+    EXPECT_EQ(Inner.DRunEnd, 5);
+    EXPECT_EQ(Scene.DRuns[1].DType, SSVGShape::EType::GroupBegin);
+    EXPECT_EQ(Scene.DRuns[6].DType, SSVGShape::EType::GroupEnd);
+    EXPECT_EQ(Scene.DRuns[6].DBegin, 0);
+    EXPECT_EQ(Scene.DRuns[5].DType, SSVGShape::EType::Circle);
+    EXPECT_EQ(Scene.DRuns[5].DBegin, 2);
+    EXPECT_EQ(Scene.DCircles.DRadius, std::vector<TSVGReal>({1, 2, 3, 4}));
+}
+
+TEST(SVGSceneTest, ReloadTest){
+    CSVGSceneLoader Loader(1024, 2, true);
+    SSVGScene Scene;
+    std::string Document = "<svg>";
+    for(int Index = 0; Index < 3000; Index++){
+        Document += "<line x1=\"" + std::to_string(Index) + "\" y1=\"0\" x2=\"1\" y2=\"1\" style=\"stroke:c" + std::to_string(Index % 5) + "\"/>";
+    }
+    Document += "</svg>";
+
+    ASSERT_TRUE(Loader.Load(std::make_shared<CStringDataSource>("<svg><circle r=\"1\"/><g/></svg>"), Scene));
+    ASSERT_TRUE(Loader.Load(std::make_shared<CStringDataSource>(Document), Scene));
+    EXPECT_EQ(Scene.DCircles.Size(), 0);
+    EXPECT_TRUE(Scene.DGroups.empty());
+    ASSERT_EQ(Scene.DLines.Size(), 3000);
+    EXPECT_EQ(Scene.DStyles.size(), 6);
+    EXPECT_EQ(Scene.DRuns.size(), 3000);
+    for(int Index = 0; Index < 3000; Index++){
+        EXPECT_EQ(Scene.DLines.DX1[Index], Index);
+    }
+}
+
+TEST(SVGSceneTest, ClearKeepsCapacityTest){
+    CSVGSceneLoader Loader;
+    SSVGScene Scene;
+    std::string Document = "<svg width=\"10\" height=\"10\"><g>";
+    for(int Index = 0; Index < 1000; Index++){
+        Document += "<circle r=\"1\"/><rect width=\"1\" height=\"1\"/><line x2=\"1\"/>";
+    }
+    Document += "</g></svg>";
+
+    ASSERT_TRUE(Loader.Load(std::make_shared<CStringDataSource>(Document), Scene));
+    std::size_t Memory = Scene.MemoryUsage();
+    const TSVGCoordinate *Circles = Scene.DCircles.DX.data();
+    const TSVGReal *Heights = Scene.DRectangles.DHeight.data();
+    const SSVGScene::TIndex *Lines = Scene.DLines.DStyle.data();
+    const SSVGScene::SRun *Runs = Scene.DRuns.data();
+    // Reloading the same document reuses every array
+    ASSERT_TRUE(Loader.Load(std::make_shared<CStringDataSource>(Document), Scene));
+    EXPECT_EQ(Scene.ShapeCount(), 3000);
+    EXPECT_EQ(Scene.MemoryUsage(), Memory);
+    EXPECT_EQ(Scene.DCircles.DX.data(), Circles);
+    EXPECT_EQ(Scene.DRectangles.DHeight.data(), Heights);
+    EXPECT_EQ(Scene.DLines.DStyle.data(), Lines);
+    EXPECT_EQ(Scene.DRuns.data(), Runs);
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "SVGSceneWriter.h"
+#include "StringDataSink.h"
+#include "StringDataSource.h"
+#include <string>
+
+// Sink that fails once limit bytes have been written
+class CFailingDataSink : public CDataSink{
+    public:
+        std::size_t DLimit;
+        std::size_t DWritten = 0;
+
+        CFailingDataSink(std::size_t limit) : DLimit(limit){
+
+        }
+
+        bool Put(const char &ch) noexcept override{
+            return Write(&ch, 1);
+        }
+
+        bool Write(const std::vector<char> &buf) noexcept override{
+            return Write(buf.data(), buf.size());
+        }
+
+        bool Write(const char *buf, std::size_t length) noexcept override{
+            DWritten += length;
+            return DWritten <= DLimit;
+        }
+};
+
+std::string SceneDocument(int shapes){
+    std::string Document = "<svg width=\"200\" height=\"100\"><g id=\"outer\">";
+    for(int Index = 0; Index < shapes; Index++){
+        std::string Style = "\" style=\"fill: c" + std::to_string(Index / 7 % 3) + "; stroke:black\"/>";
+        switch(Index % 5){
+            case 0:
+            case 1: Document += "<circle cx=\"" + std::to_string(Index) + "\" cy=\"2\" r=\"" + std::to_string(Index % 4) + Style;
+                    break;
+            case 2: Document += "<rect x=\"" + std::to_string(Index) + "\" y=\"1\" width=\"2\" height=\"3" + Style;
+                    break;
+            case 3: Document += "<g><line x1=\"" + std::to_string(Index) + "\" y1=\"0\" x2=\"1\" y2=\"1.5" + Style + "</g>";
+                    break;
+            default:Document += "<circle cx=\"x\"/>";
+                    break;
+        }
+    }
+    return Document + "</g></svg>";
+}
+
+SSVGScene LoadScene(const std::string &document){
+    CSVGSceneLoader Loader;
+    SSVGScene Scene;
+    Loader.Load(std::make_shared<CStringDataSource>(document), Scene);
+    return Scene;
+}
+
+void ExpectSameScene(const SSVGScene &actual, const SSVGScene &expected){
+    EXPECT_EQ(actual.DSize.DWidth, expected.DSize.DWidth);
+    EXPECT_EQ(actual.DSize.DHeight, expected.DSize.DHeight);
+    EXPECT_EQ(actual.DStyles, expected.DStyles);
+    EXPECT_EQ(actual.DCircles.DX, expected.DCircles.DX);
+    EXPECT_EQ(actual.DCircles.DRadius, expected.DCircles.DRadius);
+    EXPECT_EQ(actual.DCircles.DStyle, expected.DCircles.DStyle);
+    EXPECT_EQ(actual.DRectangles.DX, expected.DRectangles.DX);
+    EXPECT_EQ(actual.DRectangles.DHeight, expected.DRectangles.DHeight);
+    EXPECT_EQ(actual.DLines.DX1, expected.DLines.DX1);
+    EXPECT_EQ(actual.DLines.DY2, expected.DLines.DY2);
+    EXPECT_EQ(actual.DRuns.size(), expected.DRuns.size());
+    ASSERT_EQ(actual.DGroups.size(), expected.DGroups.size());
+    for(std::size_t Index = 0; Index < actual.DGroups.size(); Index++){
+        EXPECT_EQ(actual.DGroups[Index].DAttributes, expected.DGroups[Index].DAttributes);
+        EXPECT_EQ(actual.DGroups[Index].DParent, expected.DGroups[Index].DParent);
+        EXPECT_EQ(actual.DGroups[Index].DRunBegin, expected.DGroups[Index].DRunBegin);
+        EXPECT_EQ(actual.DGroups[Index].DRunEnd, expected.DGroups[Index].DRunEnd);
+    }
+}
+
+TEST(SVGSceneWriterTest, RoundTripTest){
+    SSVGScene Scene = LoadScene(SceneDocument(200));
+    auto Sink = std::make_shared<CStringDataSink>();
+    CSVGSceneWriter Writer(Sink);
+
+    ASSERT_TRUE(Writer.Write(Scene));
+    SSVGScene Reloaded = LoadScene(Sink->String());
+    // Styles come back exactly as they were read
+    ASSERT_EQ(Reloaded.DStyles.size(), 4);
+    EXPECT_EQ(Reloaded.DStyles[1], "fill: c0; stroke:black");
+    ExpectSameScene(Reloaded, Scene);
+}
+
+TEST(SVGSceneWriterTest, EscapeTest){
+    std::string Document = "<svg width=\"10\" height=\"10\"><g id=\"a&amp;b\" class=\"&lt;&quot;&gt;\">"
+        "<circle cx=\"1\" cy=\"2\" r=\"3\" style=\"font-family:&quot;A&lt;B&quot;;fill:red\"/></g></svg>";
+    SSVGScene Scene = LoadScene(Document);
+    ASSERT_EQ(Scene.DCircles.Size(), 1);
+    ASSERT_EQ(Scene.DGroups.size(), 1);
+
+    auto Written = std::make_shared<CStringDataSink>();
+    ASSERT_TRUE(CSVGSceneWriter(Written).Write(Scene));
+    EXPECT_NE(Written->String().find("<g id=\"a&amp;b\" class=\"&lt;&quot;>\">"), std::string::npos);
+    ExpectSameScene(LoadScene(Written->String()), Scene);
+
+    auto Piped = std::make_shared<CStringDataSink>();
+    ASSERT_TRUE(CSVGSceneWriter(Piped).Pipe(std::make_shared<CStringDataSource>(Document)));
+    EXPECT_EQ(Piped->String(), Written->String());
+}
+
+TEST(SVGSceneWriterTest, VerbatimStyleTest){
+    std::string Style = "fill:url(\"data:image/png;base64,iVBO:Rw0K\") ;  stroke : blue;;";
+    std::string Document = "<svg width=\"10\" height=\"10\"><rect x=\"1\" y=\"2\" width=\"3\" height=\"4\" style=\"" + Style + "\"/></svg>";
+    std::string Escaped = Style;
+    for(std::size_t Position = Escaped.find('"'); Position != std::string::npos; Position = Escaped.find('"', Position)){
+        Escaped.replace(Position, 1, "&quot;");
+    }
+    Document.replace(Document.find(Style), Style.size(), Escaped);
+
+    auto Sink = std::make_shared<CStringDataSink>();
+    ASSERT_TRUE(CSVGSceneWriter(Sink).Pipe(std::make_shared<CStringDataSource>(Document)));
+    EXPECT_NE(Sink->String().find("style=\"" + Escaped + "\""), std::string::npos);
+    SSVGScene Reloaded = LoadScene(Sink->String());
+    ASSERT_EQ(Reloaded.DStyles.size(), 2);
+    EXPECT_EQ(Reloaded.DStyles[1], Style);
+}
+
+TEST(SVGSceneWriterTest, InvalidSizeTest){
+    auto Sink = std::make_shared<CStringDataSink>();
+    CSVGSceneWriter Writer(Sink);
+
+    EXPECT_FALSE(Writer.Write(SSVGScene()));
+    EXPECT_FALSE(Writer.Pipe(std::make_shared<CStringDataSource>("<svg width=\"100%\" height=\"10\"><circle r=\"1\"/></svg>")));
+    EXPECT_FALSE(Writer.Pipe(std::make_shared<CStringDataSource>("<g><circle r=\"1\"/></g>")));
+    EXPECT_TRUE(Sink->String().empty());
+}
+
+TEST(SVGSceneWriterTest, PipeTest){
+    std::string Document = SceneDocument(2000);
+    auto Expected = std::make_shared<CStringDataSink>();
+    CSVGSceneWriter(Expected).Write(LoadScene(Document));
+
+    for(std::size_t BatchSize : {1, 7, 4096}){
+        for(std::size_t QueueDepth : {1, 3}){
+            auto Sink = std::make_shared<CStringDataSink>();
+            CSVGSceneWriter Writer(Sink);
+            EXPECT_TRUE(Writer.Pipe(std::make_shared<CStringDataSource>(Document), nullptr, BatchSize, QueueDepth));
+            EXPECT_EQ(Sink->String(), Expected->String());
+        }
+    }
+}
+
+TEST(SVGSceneWriterTest, FilterTest){
+    std::string Document = SceneDocument(500);
+    SSVGScene Filtered = LoadScene(Document);
+    // Expected result of dropping lines and moving circles right by 10
+    auto Sink = std::make_shared<CStringDataSink>();
+    CSVGSceneWriter Writer(Sink);
+    ASSERT_TRUE(Writer.Pipe(std::make_shared<CStringDataSource>(Document), [](SSVGShape &shape, const SXMLEntityView &entity){
+        if(shape.DType == SSVGShape::EType::Circle){
+            shape.DPoint.DX += 10;
+        }
+        return shape.DType != SSVGShape::EType::Line && entity.DNameData != "line";
+    }, 16, 2));
+
+    SSVGScene Reloaded = LoadScene(Sink->String());
+    EXPECT_EQ(Reloaded.DLines.Size(), 0);
+    EXPECT_EQ(Reloaded.DRectangles.DX, Filtered.DRectangles.DX);
+    ASSERT_EQ(Reloaded.DCircles.Size(), Filtered.DCircles.Size());
+    for(std::size_t Index = 0; Index < Reloaded.DCircles.Size(); Index++){
+        EXPECT_EQ(Reloaded.DCircles.DX[Index], Filtered.DCircles.DX[Index] + 10);
+    }
+    EXPECT_EQ(Reloaded.DGroups.size(), Filtered.DGroups.size());
+}
+
+TEST(SVGSceneWriterTest, FailingSinkTest){
+    std::string Document = SceneDocument(5000);
+    for(std::size_t Limit : {0, 100, 10000}){
+        CSVGSceneWriter Writer(std::make_shared<CFailingDataSink>(Limit));
+        EXPECT_FALSE(Writer.Pipe(std::make_shared<CStringDataSource>(Document), nullptr, 8, 1));
+        EXPECT_FALSE(Writer.Write(LoadScene(Document)));
+    }
+}
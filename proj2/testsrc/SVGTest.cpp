@@ -1,5 +1,10 @@
 #include "svg.h"
+#include "svg_number.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <string>
 #include <vector>
 
@@ -118,4 +123,399 @@ svg_return_t write_error_callback(svg_user_context_ptr user, const char* text){
 
 TEST_F(SVGTest, IOErrorTest){
 
-}
\ No newline at end of file
+}
+// --- BUFFERING TESTS ---
+TEST_F(SVGTest, BufferedOutput){
+    svg_point_t Center{50, 50};
+    std::size_t HeaderWrites = DOutput.DLines.size();
+
+    for(int Index = 0; Index < 100; Index++){
+        EXPECT_EQ(svg_circle(DContext, &Center, 10, "fill:red"), SVG_OK);
+    }
+    EXPECT_EQ(DOutput.DLines.size(), HeaderWrites);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    EXPECT_EQ(DOutput.DLines.size(), HeaderWrites + 1);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    EXPECT_EQ(DOutput.DLines.size(), HeaderWrites + 1);
+    EXPECT_NE(DOutput.JoinOutput().find("<circle"), std::string::npos);
+}
+
+TEST_F(SVGTest, UnbufferedOutput){
+    STestOutput Output;
+    svg_point_t Center{50, 50};
+    svg_context_ptr Context = svg_create_buffered(write_callback, cleanup_callback, &Output, 100, 100, 0);
+
+    ASSERT_NE(Context, nullptr);
+    EXPECT_EQ(Output.DLines.size(), 1);
+    EXPECT_EQ(svg_circle(Context, &Center, 10, nullptr), SVG_OK);
+    EXPECT_EQ(Output.DLines.size(), 2);
+    EXPECT_EQ(svg_group_end(Context), SVG_OK);
+    EXPECT_EQ(Output.DLines.size(), 3);
+    EXPECT_EQ(svg_destroy(Context), SVG_OK);
+    EXPECT_EQ(Output.DLines.size(), 4);
+    EXPECT_EQ(Output.DLines.back(), "</svg>\n");
+}
+
+TEST_F(SVGTest, SmallBufferOverflow){
+    STestOutput Output;
+    svg_point_t Center{50, 50};
+    svg_context_ptr Context = svg_create_buffered(write_callback, cleanup_callback, &Output, 100, 100, 16);
+
+    ASSERT_NE(Context, nullptr);
+    EXPECT_EQ(svg_circle(Context, &Center, 10, nullptr), SVG_OK);
+    EXPECT_EQ(svg_group_end(Context), SVG_OK);
+    EXPECT_EQ(svg_group_end(Context), SVG_OK);
+    EXPECT_EQ(svg_destroy(Context), SVG_OK);
+    std::string Result = Output.JoinOutput();
+    EXPECT_NE(Result.find("<circle"), std::string::npos);
+    EXPECT_NE(Result.find("/>\n</g>\n</g>\n</svg>\n"), std::string::npos);
+    EXPECT_TRUE(Output.DDestroyed);
+}
+
+TEST_F(SVGTest, FlushErrors){
+    int FailureCount = 1;
+    svg_point_t Center{50, 50};
+
+    EXPECT_EQ(svg_flush(nullptr), SVG_ERR_NULL);
+    svg_context_ptr Context = svg_create_buffered(write_error_callback, cleanup_callback, &FailureCount, 100, 100, 1024);
+    ASSERT_NE(Context, nullptr);
+    EXPECT_EQ(svg_flush(Context), SVG_OK);
+    EXPECT_EQ(svg_circle(Context, &Center, 10, nullptr), SVG_OK);
+    EXPECT_EQ(svg_flush(Context), SVG_ERR_IO);
+    // The lost circle makes every later call fail
+    EXPECT_EQ(svg_flush(Context), SVG_ERR_IO);
+    EXPECT_EQ(svg_circle(Context, &Center, 10, nullptr), SVG_ERR_IO);
+    EXPECT_EQ(svg_group_end(Context), SVG_ERR_IO);
+    EXPECT_EQ(svg_flush(Context), SVG_ERR_IO);
+    EXPECT_EQ(svg_destroy(Context), SVG_ERR_IO);
+
+    // An unbuffered context fails the same way
+    FailureCount = 1;
+    Context = svg_create_buffered(write_error_callback, cleanup_callback, &FailureCount, 100, 100, 0);
+    ASSERT_NE(Context, nullptr);
+    EXPECT_EQ(svg_circle(Context, &Center, 10, nullptr), SVG_ERR_IO);
+    EXPECT_EQ(svg_group_end(Context), SVG_ERR_IO);
+    EXPECT_EQ(svg_destroy(Context), SVG_ERR_IO);
+}
+
+TEST_F(SVGTest, LongStyle){
+    std::string Style = "fill:" + std::string(100000, 'a');
+    std::string Attributes = "class=\"" + std::string(300, 'b') + "\"";
+    svg_point_t Center{50, 50};
+
+    EXPECT_EQ(svg_group_begin(DContext, Attributes.c_str()), SVG_OK);
+    EXPECT_EQ(svg_circle(DContext, &Center, 10, Style.c_str()), SVG_OK);
+    EXPECT_EQ(svg_group_end(DContext), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    std::string Output = DOutput.JoinOutput();
+    EXPECT_NE(Output.find("<g " + Attributes + ">\n<circle cx=\"50\" cy=\"50\" r=\"10\" style=\"" + Style + "\"/>\n</g>\n"), std::string::npos);
+
+    for(std::size_t BufferSize : {(std::size_t)0, (std::size_t)16, (std::size_t)1024}){
+        STestOutput SmallOutput;
+        svg_context_ptr Context = svg_create_buffered(write_callback, cleanup_callback, &SmallOutput, 100, 100, BufferSize);
+        ASSERT_NE(Context, nullptr);
+        EXPECT_EQ(svg_circle(Context, &Center, 10, Style.c_str()), SVG_OK);
+        EXPECT_EQ(svg_group_begin(Context, Attributes.c_str()), SVG_OK);
+        if(!BufferSize){
+            EXPECT_EQ(SmallOutput.DLines.size(), 3);
+            EXPECT_EQ(SmallOutput.DLines[1], "<circle cx=\"50\" cy=\"50\" r=\"10\" style=\"" + Style + "\"/>\n");
+        }
+        EXPECT_EQ(svg_destroy(Context), SVG_OK);
+        EXPECT_EQ(SmallOutput.JoinOutput(), "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg width=\"100\" height=\"100\" xmlns=\"http://www.w3.org/2000/svg\">\n"
+            "<circle cx=\"50\" cy=\"50\" r=\"10\" style=\"" + Style + "\"/>\n<g " + Attributes + ">\n</svg>\n");
+    }
+}
+
+// --- NUMBER FORMAT TESTS ---
+TEST_F(SVGTest, CompactNumbers){
+    svg_point_t Center{50, 50.25};
+
+    EXPECT_EQ(svg_circle(DContext, &Center, 1.0/3.0, nullptr), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    EXPECT_NE(DOutput.JoinOutput().find("<circle cx=\"50\" cy=\"50.25\" r=\"0.3333333333333333\" style=\"\"/>"), std::string::npos);
+}
+
+TEST_F(SVGTest, Precision){
+    svg_point_t Start{1.0/3.0, 2};
+    svg_point_t End{10.126, 20.5};
+
+    EXPECT_EQ(svg_set_precision(nullptr, 2), SVG_ERR_NULL);
+    EXPECT_EQ(svg_set_precision(DContext, -2), SVG_ERR_INVALID_ARG);
+    EXPECT_EQ(svg_set_precision(DContext, SVG_PRECISION_MAX + 1), SVG_ERR_INVALID_ARG);
+    EXPECT_EQ(svg_set_precision(DContext, 2), SVG_OK);
+    EXPECT_EQ(svg_line(DContext, &Start, &End, nullptr), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    EXPECT_NE(DOutput.JoinOutput().find("<line x1=\"0.33\" y1=\"2\" x2=\"10.13\" y2=\"20.5\""), std::string::npos);
+}
+
+// --- BATCH TESTS ---
+TEST_F(SVGTest, BatchCircles){
+    std::vector<svg_real_t> X, Y, R;
+    std::string Expected;
+
+    for(int Index = 0; Index < 150; Index++){
+        svg_point_t Center{Index * 0.5, 100.0 - Index};
+        X.push_back(Center.x);
+        Y.push_back(Center.y);
+        R.push_back(Index / 3.0);
+        EXPECT_EQ(svg_circle(DContext, &Center, R.back(), "fill:red"), SVG_OK);
+    }
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    Expected = DOutput.JoinOutput();
+    DOutput.DLines.clear();
+    EXPECT_EQ(svg_circles(DContext, X.data(), Y.data(), R.data(), X.size(), "fill:red"), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    EXPECT_EQ(Expected.substr(Expected.find("<circle")), DOutput.JoinOutput());
+}
+
+TEST_F(SVGTest, BatchRectsAndLines){
+    std::vector<svg_real_t> A{1, 2}, B{3, 4}, C{5, 6}, D{7, 8};
+
+    EXPECT_EQ(svg_set_precision(DContext, 1), SVG_OK);
+    EXPECT_EQ(svg_rects(DContext, A.data(), B.data(), C.data(), D.data(), A.size(), nullptr), SVG_OK);
+    EXPECT_EQ(svg_lines(DContext, A.data(), B.data(), C.data(), D.data(), A.size(), "stroke:red"), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    std::string Output = DOutput.JoinOutput();
+    EXPECT_NE(Output.find("<rect x=\"1\" y=\"3\" width=\"5\" height=\"7\" style=\"\"/>\n<rect x=\"2\""), std::string::npos);
+    EXPECT_NE(Output.find("<line x1=\"2\" y1=\"4\" x2=\"6\" y2=\"8\" style=\"stroke:red\"/>"), std::string::npos);
+}
+
+TEST_F(SVGTest, BatchNullArrays){
+    svg_real_t Value = 1;
+
+    EXPECT_EQ(svg_circles(nullptr, &Value, &Value, &Value, 1, nullptr), SVG_ERR_NULL);
+    EXPECT_EQ(svg_circles(DContext, &Value, nullptr, &Value, 1, nullptr), SVG_ERR_NULL);
+    EXPECT_EQ(svg_rects(DContext, &Value, &Value, &Value, nullptr, 1, nullptr), SVG_ERR_NULL);
+    EXPECT_EQ(svg_lines(DContext, nullptr, &Value, &Value, &Value, 1, nullptr), SVG_ERR_NULL);
+    EXPECT_EQ(svg_circles(DContext, nullptr, nullptr, nullptr, 0, nullptr), SVG_OK);
+}
+
+// --- PATH TESTS ---
+TEST_F(SVGTest, Path){
+    std::vector<svg_point_t> Points{{0, 0}, {10.5, -2}, {-3, -4}, {20, 1.0/3.0}};
+
+    EXPECT_EQ(svg_path(DContext, Points.data(), Points.size(), nullptr, "stroke:red"), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    EXPECT_NE(DOutput.JoinOutput().find("<path d=\"M0 0L10.5-2-3-4 20 0.3333333333333333\" style=\"stroke:red\"/>\n"), std::string::npos);
+}
+
+TEST_F(SVGTest, RelativePath){
+    std::vector<svg_point_t> Points{{1, 1}, {1.004, 2}, {1.008, 2}, {1.012, 2}, {0.5, 3}};
+    svg_path_options_t Options{1, 0, 2};
+
+    EXPECT_EQ(svg_path(DContext, Points.data(), Points.size(), &Options, nullptr), SVG_OK);
+    // Deltas of the rounded positions, so 1.01 after two 0.00 steps
+    Options.precision = SVG_PRECISION_SHORTEST;
+    Points = {{5, 5}, {6.5, 4}, {6.5, 4}};
+    EXPECT_EQ(svg_path(DContext, Points.data(), Points.size(), &Options, nullptr), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    std::string Output = DOutput.JoinOutput();
+    EXPECT_NE(Output.find("<path d=\"M1 1l0 1 0.01 0 0 0-0.51 1\" style=\"\"/>\n"), std::string::npos);
+    EXPECT_NE(Output.find("<path d=\"M5 5l1.5-1 0 0\" style=\"\"/>\n"), std::string::npos);
+}
+
+TEST_F(SVGTest, PathTolerance){
+    std::vector<svg_point_t> Points{{0, 0}, {1, 1}, {2, 2}, {2.1, 2.05}, {3, 3.001}, {3, 0}, {3.01, 0.02}, {4, 4}, {5, 4}, {5.01, 4}};
+    svg_path_options_t Options{0, 0.05, SVG_PRECISION_SHORTEST};
+
+    EXPECT_EQ(svg_path(DContext, Points.data(), Points.size(), &Options, nullptr), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    // Collinear and near points go, the spike and the last point stay
+    EXPECT_NE(DOutput.JoinOutput().find("<path d=\"M0 0L3 3.001 3 0 4 4 5.01 4\" style=\"\"/>\n"), std::string::npos);
+}
+
+// Distance from a point to the segment from first to second
+double SegmentDistance(const svg_point_t &point, const svg_point_t &first, const svg_point_t &second){
+    double DX = second.x - first.x, DY = second.y - first.y;
+    double Length2 = DX * DX + DY * DY;
+    double Along = Length2 ? ((point.x - first.x) * DX + (point.y - first.y) * DY) / Length2 : 0;
+    Along = std::min(1.0, std::max(0.0, Along));
+    return std::hypot(point.x - first.x - Along * DX, point.y - first.y - Along * DY);
+}
+
+TEST_F(SVGTest, PathToleranceBound){
+    const double Tolerance = 0.5;
+    std::vector<svg_point_t> Points;
+    for(int Index = 0; Index < 10000; Index++){
+        double Angle = M_PI * Index / 9999;
+        Points.push_back({500 + 200 * std::cos(Angle), 500 - 200 * std::sin(Angle)});
+    }
+    svg_path_options_t Options{0, Tolerance, 2};
+
+    EXPECT_EQ(svg_path(DContext, Points.data(), Points.size(), &Options, nullptr), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    std::string Output = DOutput.JoinOutput();
+    std::size_t Start = Output.find("<path d=\"M");
+    ASSERT_NE(Start, std::string::npos);
+    std::vector<svg_point_t> Kept;
+    const char *Cursor = Output.c_str() + Start + 10;
+    while(*Cursor != '"'){
+        char *End;
+        svg_real_t X = std::strtod(Cursor + (*Cursor == 'L'), &End);
+        svg_real_t Y = std::strtod(End, &End);
+        Kept.push_back({X, Y});
+        Cursor = End;
+    }
+    EXPECT_GT(Kept.size(), 2u);
+    EXPECT_LT(Kept.size(), 100u);
+    // Every input point lies within tolerance of the polyline, allowing for
+    // rounding to two places
+    double Worst = 0;
+    for(auto &Point : Points){
+        double Distance = SegmentDistance(Point, Kept[0], Kept[1]);
+        for(std::size_t Index = 1; Index + 1 < Kept.size(); Index++){
+            Distance = std::min(Distance, SegmentDistance(Point, Kept[Index], Kept[Index + 1]));
+        }
+        Worst = std::max(Worst, Distance);
+    }
+    EXPECT_LE(Worst, Tolerance + 0.005 * std::sqrt(2.0));
+}
+
+TEST_F(SVGTest, LongPath){
+    std::vector<svg_point_t> Points;
+    std::string Expected = "<path d=\"M0 0L";
+    for(int Index = 0; Index < 5000; Index++){
+        Points.push_back({(svg_real_t)Index, (svg_real_t)(Index % 7)});
+        if(Index){
+            Expected += (Index > 1 ? " " : "") + std::to_string(Index) + " " + std::to_string(Index % 7);
+        }
+    }
+    std::string Style(1000, 'a');
+    Expected += "\" style=\"" + Style + "\"/>\n";
+
+    EXPECT_EQ(svg_path(DContext, Points.data(), Points.size(), nullptr, Style.c_str()), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    std::string Output = DOutput.JoinOutput();
+    EXPECT_EQ(Output.substr(Output.find("<path")), Expected);
+}
+
+TEST_F(SVGTest, PathErrors){
+    svg_point_t Points[2] = {{0, 0}, {1, 1}};
+    svg_path_options_t Options{0, 0, SVG_PRECISION_MAX + 1};
+
+    EXPECT_EQ(svg_path(nullptr, Points, 2, nullptr, nullptr), SVG_ERR_NULL);
+    EXPECT_EQ(svg_path(DContext, nullptr, 2, nullptr, nullptr), SVG_ERR_NULL);
+    EXPECT_EQ(svg_path(DContext, Points, 1, nullptr, nullptr), SVG_ERR_INVALID_ARG);
+    EXPECT_EQ(svg_path(DContext, Points, 2, &Options, nullptr), SVG_ERR_INVALID_ARG);
+}
+
+// --- DECIMATION TESTS ---
+svg_return_t collect_point(svg_user_context_ptr user, const svg_point_t *point){
+    static_cast<std::vector<svg_point_t> *>(user)->push_back(*point);
+    return SVG_OK;
+}
+
+svg_return_t failing_point(svg_user_context_ptr user, const svg_point_t *point){
+    return SVG_ERR_IO;
+}
+
+// Pixels of a size x size canvas touched by a polyline, found by sampling
+// every segment at sub-pixel steps
+std::vector<bool> RasterizePolyline(const std::vector<svg_point_t> &points, int size){
+    std::vector<bool> Pixels(size * size, false);
+    for(std::size_t Index = 1; Index < points.size(); Index++){
+        const svg_point_t &Start = points[Index - 1], &End = points[Index];
+        int Steps = 1 + (int)(std::max(std::abs(End.x - Start.x), std::abs(End.y - Start.y)) * 16);
+        for(int Step = 0; Step <= Steps; Step++){
+            double Fraction = (double)Step / Steps;
+            int X = (int)std::floor(Start.x + (End.x - Start.x) * Fraction);
+            int Y = (int)std::floor(Start.y + (End.y - Start.y) * Fraction);
+            if(X >= 0 && X < size && Y >= 0 && Y < size){
+                Pixels[Y * size + X] = true;
+            }
+        }
+    }
+    return Pixels;
+}
+
+std::size_t PixelDifference(const std::vector<bool> &first, const std::vector<bool> &second){
+    std::size_t Count = 0;
+    for(std::size_t Index = 0; Index < first.size(); Index++){
+        Count += first[Index] != second[Index];
+    }
+    return Count;
+}
+
+std::vector<svg_point_t> NoisySeries(std::size_t count, svg_real_t width){
+    std::vector<svg_point_t> Points;
+    std::uint32_t Noise = 7;
+    for(std::size_t Index = 0; Index < count; Index++){
+        Noise = Noise * 1664525 + 1013904223;
+        svg_real_t X = Index * width / count;
+        Points.push_back({X, 50 + 30 * std::sin(X / 9) + (Noise >> 24) / 32.0});
+    }
+    return Points;
+}
+
+TEST_F(SVGTest, DecimateNone){
+    std::vector<svg_point_t> Points = NoisySeries(1000, 100), Kept;
+
+    EXPECT_EQ(svg_decimate(DContext, Points.data(), Points.size(), collect_point, &Kept), SVG_OK);
+    ASSERT_EQ(Kept.size(), Points.size());
+    EXPECT_EQ(Kept.back().y, Points.back().y);
+}
+
+TEST_F(SVGTest, DecimateMinMax){
+    std::vector<svg_point_t> Points = NoisySeries(20000, 100), Kept;
+
+    EXPECT_EQ(svg_set_decimation(DContext, SVG_DECIMATE_MINMAX), SVG_OK);
+    EXPECT_EQ(svg_decimate(DContext, Points.data(), Points.size(), collect_point, &Kept), SVG_OK);
+    EXPECT_LE(Kept.size(), 400);
+    EXPECT_EQ(Kept.front().x, Points.front().x);
+    EXPECT_EQ(Kept.back().x, Points.back().x);
+    for(std::size_t Index = 1; Index < Kept.size(); Index++){
+        EXPECT_LE(Kept[Index - 1].x, Kept[Index].x);
+    }
+    std::vector<bool> Full = RasterizePolyline(Points, 100);
+    std::vector<bool> Decimated = RasterizePolyline(Kept, 100);
+    // Every column keeps its extremes, so the same pixels are touched
+    EXPECT_EQ(PixelDifference(Full, Decimated), 0);
+}
+
+TEST_F(SVGTest, DecimateLTTB){
+    std::vector<svg_point_t> Points = NoisySeries(20000, 100), Kept;
+
+    EXPECT_EQ(svg_set_decimation(DContext, SVG_DECIMATE_LTTB), SVG_OK);
+    EXPECT_EQ(svg_decimate(DContext, Points.data(), Points.size(), collect_point, &Kept), SVG_OK);
+    ASSERT_EQ(Kept.size(), 200);
+    EXPECT_EQ(Kept.front().x, Points.front().x);
+    EXPECT_EQ(Kept.back().x, Points.back().x);
+    std::vector<bool> Full = RasterizePolyline(Points, 100);
+    std::vector<bool> Decimated = RasterizePolyline(Kept, 100);
+    std::size_t Covered = std::count(Full.begin(), Full.end(), true);
+    // LTTB keeps the shape but not every extreme
+    EXPECT_LE(PixelDifference(Full, Decimated), Covered / 4);
+
+    // Short polylines are passed through whole
+    Kept.clear();
+    EXPECT_EQ(svg_decimate(DContext, Points.data(), 150, collect_point, &Kept), SVG_OK);
+    EXPECT_EQ(Kept.size(), 150);
+}
+
+TEST_F(SVGTest, DecimatedPath){
+    std::vector<svg_point_t> Points = NoisySeries(20000, 100);
+
+    EXPECT_EQ(svg_set_decimation(DContext, SVG_DECIMATE_MINMAX), SVG_OK);
+    EXPECT_EQ(svg_path(DContext, Points.data(), Points.size(), nullptr, nullptr), SVG_OK);
+    EXPECT_EQ(svg_flush(DContext), SVG_OK);
+    std::string Output = DOutput.JoinOutput();
+    std::size_t Begin = Output.find("<path");
+    ASSERT_NE(Begin, std::string::npos);
+    EXPECT_LT(Output.find("/>", Begin) - Begin, 400 * 40);
+}
+
+TEST_F(SVGTest, DecimateErrors){
+    svg_point_t Points[3] = {{0, 0}, {1, 1}, {2, 0}};
+    std::vector<svg_point_t> Kept;
+
+    EXPECT_EQ(svg_set_decimation(nullptr, SVG_DECIMATE_MINMAX), SVG_ERR_NULL);
+    EXPECT_EQ(svg_set_decimation(DContext, (svg_decimate_t)7), SVG_ERR_INVALID_ARG);
+    EXPECT_EQ(svg_decimate(nullptr, Points, 3, collect_point, &Kept), SVG_ERR_NULL);
+    EXPECT_EQ(svg_decimate(DContext, nullptr, 3, collect_point, &Kept), SVG_ERR_NULL);
+    EXPECT_EQ(svg_decimate(DContext, Points, 3, nullptr, &Kept), SVG_ERR_NULL);
+    EXPECT_EQ(svg_decimate(DContext, Points, 3, failing_point, nullptr), SVG_ERR_IO);
+    EXPECT_EQ(svg_set_decimation(DContext, SVG_DECIMATE_MINMAX), SVG_OK);
+    EXPECT_EQ(svg_decimate(DContext, Points, 3, failing_point, nullptr), SVG_ERR_IO);
+    EXPECT_EQ(svg_decimate(DContext, nullptr, 0, collect_point, &Kept), SVG_OK);
+    EXPECT_TRUE(Kept.empty());
+}
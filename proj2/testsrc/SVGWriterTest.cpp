@@ -10,35 +10,82 @@ TEST(SVGWriterTest, CreateDestroyTest){
 }
 
 TEST(SVGWriterTest, CircleTest){
-    std::shared_ptr<SStringDataSink> Sink = std::make_shared<CStringDataSink>();
-    CSVGWriter Writer(Sink, 100, 100);
-    SSVGPoint center{50, 50}; 
-    TSVGReal radius = 25;
-    TAttributes style;
-    bool result = Writer.Circle(center, radius, style);
-    EXPECT_TRUE(result);
-    std::string SVGOutput = Sink->GetString();
-
-    EXPECT_NE(svgOutput.find("<circle"), std::strign::npos);
-    EXPECT_NE(svgOutput.find("cx=\"50\""), std::string::npos);
-    EXPECT_NE(svgOutput.find(cy=\"50\""), std::string::npos);
-    EXPECT_NE(svgOutput.find("r=\"25\""), std::string::npos);
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        SSVGPoint center{50, 50}; 
+        TSVGReal radius = 25;
+        TAttributes style;
+        bool result = Writer.Circle(center, radius, style);
+        EXPECT_TRUE(result);
+    }
+    std::string SVGOutput = Sink->String();
+
+    EXPECT_NE(SVGOutput.find("<circle"), std::string::npos);
+    EXPECT_NE(SVGOutput.find("cx=\"50\""), std::string::npos);
+    EXPECT_NE(SVGOutput.find("cy=\"50\""), std::string::npos);
+    EXPECT_NE(SVGOutput.find("r=\"25\""), std::string::npos);
 }
 
 TEST(SVGWriterTest, RectangleTest){
-    FAIL() << "should fail";
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        TAttributes style{{"fill","red"},{"stroke","black"}};
+        EXPECT_TRUE(Writer.Rectange({10, 20}, {30, 40.5}, style));
+    }
+    EXPECT_NE(Sink->String().find("<rect x=\"10\" y=\"20\" width=\"30\" height=\"40.5\" style=\"fill:red;stroke:black\"/>"), std::string::npos);
 }
 
 TEST(SVGWriterTest, LineTest){
-    FAIL() << "should fail";
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        TAttributes style{{"stroke","blue"}};
+        EXPECT_TRUE(Writer.Line({0, 0}, {100, 50}, style));
+    }
+    EXPECT_NE(Sink->String().find("<line x1=\"0\" y1=\"0\" x2=\"100\" y2=\"50\" style=\"stroke:blue\"/>"), std::string::npos);
 }
 
 TEST(SVGWriterTest, SimplePathTest){
-    FAIL() << "should fail";
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        TAttributes style{{"stroke","blue"}};
+        EXPECT_FALSE(Writer.SimplePath({{0, 0}}, style));
+        EXPECT_TRUE(Writer.SimplePath({{0, 0}, {10, 10}, {20, 0}}, style));
+    }
+    EXPECT_NE(Sink->String().find("x1=\"0\" y1=\"0\" x2=\"10\" y2=\"10\""), std::string::npos);
+    EXPECT_NE(Sink->String().find("x1=\"10\" y1=\"10\" x2=\"20\" y2=\"0\""), std::string::npos);
 }
 
 TEST(SVGWriterTest, GroupTest){
-    FAIL() << "should fail";
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        EXPECT_TRUE(Writer.GroupBegin({{"id","layer"},{"opacity","0.5"}}));
+        EXPECT_TRUE(Writer.Circle({1, 2}, 3, {}));
+        EXPECT_TRUE(Writer.GroupEnd());
+    }
+    EXPECT_NE(Sink->String().find("<g id=\"layer\" opacity=\"0.5\">\n<circle"), std::string::npos);
+    EXPECT_NE(Sink->String().find("</g>\n</svg>\n"), std::string::npos);
+}
+
+TEST(SVGWriterTest, BatchTest){
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    std::vector<TSVGReal> X{1, 2, 3}, Y{4, 5, 6}, R{7, 8, 9};
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        TAttributes style{{"fill","green"}};
+        EXPECT_TRUE(Writer.Circles(X.data(), Y.data(), R.data(), X.size(), style));
+        EXPECT_TRUE(Writer.Rectangles(X.data(), Y.data(), R.data(), R.data(), X.size(), style));
+        EXPECT_TRUE(Writer.Lines(X.data(), Y.data(), R.data(), R.data(), X.size(), style));
+        EXPECT_TRUE(Writer.Circles(nullptr, nullptr, nullptr, 0, style));
+        EXPECT_FALSE(Writer.Circles(nullptr, Y.data(), R.data(), 1, style));
+    }
+    EXPECT_NE(Sink->String().find("<circle cx=\"3\" cy=\"6\" r=\"9\" style=\"fill:green\"/>"), std::string::npos);
+    EXPECT_NE(Sink->String().find("<rect x=\"2\" y=\"5\" width=\"8\" height=\"8\" style=\"fill:green\"/>"), std::string::npos);
+    EXPECT_NE(Sink->String().find("<line x1=\"1\" y1=\"4\" x2=\"7\" y2=\"7\" style=\"fill:green\"/>"), std::string::npos);
 }
 
 class CFailingSink : public CDataSink{
@@ -60,8 +107,181 @@ class CFailingSink : public CDataSink{
             }
             return false;
         }
+
+        bool Write(const char *buf, std::size_t length) noexcept override{
+            if(DValidCalls){
+                DValidCalls--;
+                return true;
+            }
+            return false;
+        }
 };
 
 TEST(SVGWriterTest, ErrorTests){
-    FAIL() << "should fail";
+    std::shared_ptr<CFailingSink> Sink = std::make_shared<CFailingSink>();
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        EXPECT_FALSE(Writer.Circle({50, 50}, 25, {}));
+        EXPECT_FALSE(Writer.GroupEnd());
+        EXPECT_FALSE(Writer.Flush());
+    }
+    Sink->DValidCalls = 1;
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        EXPECT_TRUE(Writer.Circle({50, 50}, 25, {}));
+        EXPECT_FALSE(Writer.Flush());
+        EXPECT_FALSE(Writer.Flush());
+        EXPECT_FALSE(Writer.Circle({50, 50}, 25, {}));
+    }
+    Sink->DValidCalls = 2;
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        EXPECT_TRUE(Writer.Line({0, 0}, {50, 50}, {}));
+        EXPECT_TRUE(Writer.Flush());
+        EXPECT_TRUE(Writer.GroupEnd());
+        EXPECT_FALSE(Writer.Flush());
+    }
+}
+
+TEST(SVGWriterTest, EscapeTest){
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        EXPECT_TRUE(Writer.GroupBegin({{"id","a&b"},{"title","\"<x>\""}}));
+        EXPECT_TRUE(Writer.Circle({50, 50}, 25, {{"font-family","\"A<B\""}}));
+        SSVGStyleHandle Style = Writer.RegisterStyle({{"content","\"&\""}});
+        EXPECT_TRUE(Writer.Line({0, 0}, {1, 1}, Style));
+        EXPECT_TRUE(Writer.GroupEnd());
+    }
+    EXPECT_NE(Sink->String().find("<g id=\"a&amp;b\" title=\"&quot;&lt;x>&quot;\">"), std::string::npos);
+    EXPECT_NE(Sink->String().find("style=\"font-family:&quot;A&lt;B&quot;\""), std::string::npos);
+    EXPECT_NE(Sink->String().find("style=\"content:&quot;&amp;&quot;\""), std::string::npos);
+}
+
+TEST(SVGWriterTest, FlushTest){
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    CSVGWriter Writer(Sink, 100, 100);
+
+    EXPECT_TRUE(Writer.Circle({50, 50}, 25, {}));
+    EXPECT_EQ(Sink->String().find("<circle"), std::string::npos);
+    EXPECT_TRUE(Writer.Flush());
+    EXPECT_NE(Sink->String().find("<circle"), std::string::npos);
+}
+
+TEST(SVGWriterTest, StyleCacheTest){
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    {
+        CSVGWriter Writer(Sink, 100, 100, 2);
+        TAttributes Red{{"fill","red"}}, Blue{{"fill","blue"}}, Green{{"fill","green"}};
+        // Same characters split differently must not share an entry
+        TAttributes Shifted{{"fil","lred"}};
+
+        EXPECT_TRUE(Writer.Circle({1, 1}, 1, Red));
+        EXPECT_TRUE(Writer.Circle({2, 2}, 1, Red));
+        EXPECT_TRUE(Writer.Circle({3, 3}, 1, Blue));
+        EXPECT_TRUE(Writer.Circle({4, 4}, 1, Red));
+        CSVGWriter::SStyleCacheStats Stats = Writer.StyleCacheStats();
+        EXPECT_EQ(Stats.DSize, 2);
+        EXPECT_EQ(Stats.DHits, 2);
+        EXPECT_EQ(Stats.DMisses, 2);
+        EXPECT_EQ(Stats.HitRate(), 0.5);
+
+        // Blue is least recently used, so Green evicts it
+        EXPECT_TRUE(Writer.Circle({5, 5}, 1, Green));
+        EXPECT_TRUE(Writer.Circle({6, 6}, 1, Red));
+        EXPECT_TRUE(Writer.Circle({7, 7}, 1, Blue));
+        EXPECT_TRUE(Writer.Circle({8, 8}, 1, Shifted));
+        Stats = Writer.StyleCacheStats();
+        EXPECT_EQ(Stats.DSize, 2);
+        EXPECT_EQ(Stats.DHits, 3);
+        EXPECT_EQ(Stats.DMisses, 5);
+    }
+    EXPECT_NE(Sink->String().find("<circle cx=\"6\" cy=\"6\" r=\"1\" style=\"fill:red\"/>"), std::string::npos);
+    EXPECT_NE(Sink->String().find("<circle cx=\"7\" cy=\"7\" r=\"1\" style=\"fill:blue\"/>"), std::string::npos);
+    EXPECT_NE(Sink->String().find("<circle cx=\"8\" cy=\"8\" r=\"1\" style=\"fil:lred\"/>"), std::string::npos);
+}
+
+TEST(SVGWriterTest, UncachedStyleTest){
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    {
+        CSVGWriter Writer(Sink, 100, 100, 0);
+        EXPECT_TRUE(Writer.Line({0, 0}, {1, 1}, {{"stroke","black"}}));
+        EXPECT_TRUE(Writer.Line({0, 0}, {2, 2}, {{"stroke","black"}}));
+        EXPECT_EQ(Writer.StyleCacheStats().DSize, 0);
+        EXPECT_EQ(Writer.StyleCacheStats().DHits, 0);
+        EXPECT_EQ(Writer.StyleCacheStats().DMisses, 2);
+    }
+    EXPECT_NE(Sink->String().find("<line x1=\"0\" y1=\"0\" x2=\"2\" y2=\"2\" style=\"stroke:black\"/>"), std::string::npos);
+}
+
+TEST(SVGWriterTest, StyleHandleTest){
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    std::vector<TSVGReal> X{1, 2}, Y{3, 4};
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        SSVGStyleHandle Fill = Writer.RegisterStyle({{"fill","red"},{"stroke","none"}});
+        SSVGStyleHandle Empty = Writer.RegisterStyle({});
+
+        EXPECT_TRUE(Writer.Circle({1, 2}, 3, Fill));
+        EXPECT_TRUE(Writer.Rectange({1, 2}, {3, 4}, Empty));
+        EXPECT_TRUE(Writer.Line({1, 2}, {3, 4}, Fill));
+        EXPECT_TRUE(Writer.Circles(X.data(), Y.data(), X.data(), X.size(), Fill));
+        EXPECT_TRUE(Writer.Rectangles(X.data(), Y.data(), X.data(), Y.data(), X.size(), Fill));
+        EXPECT_TRUE(Writer.Lines(X.data(), Y.data(), Y.data(), X.data(), X.size(), Fill));
+        EXPECT_FALSE(Writer.Circle({1, 2}, 3, SSVGStyleHandle(2)));
+        EXPECT_FALSE(Writer.Lines(X.data(), Y.data(), Y.data(), X.data(), X.size(), SSVGStyleHandle(7)));
+        // Handles bypass the cache
+        EXPECT_EQ(Writer.StyleCacheStats().DHits + Writer.StyleCacheStats().DMisses, 0);
+    }
+    EXPECT_NE(Sink->String().find("<circle cx=\"1\" cy=\"2\" r=\"3\" style=\"fill:red;stroke:none\"/>"), std::string::npos);
+    EXPECT_NE(Sink->String().find("<rect x=\"1\" y=\"2\" width=\"3\" height=\"4\" style=\"\"/>"), std::string::npos);
+    EXPECT_NE(Sink->String().find("<line x1=\"2\" y1=\"4\" x2=\"4\" y2=\"2\" style=\"fill:red;stroke:none\"/>"), std::string::npos);
+    EXPECT_EQ(Sink->String().find("<circle cx=\"1\" cy=\"2\" r=\"3\" style=\"fill:red;stroke:none\"/>\n<circle cx=\"1\" cy=\"2\" r=\"3\""), std::string::npos);
+}
+
+TEST(SVGWriterTest, PathTest){
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    std::vector<SSVGPoint> Points{{10, 20}, {10.25, 19}, {10.5, 18}, {30.125, 40}};
+    {
+        CSVGWriter Writer(Sink, 100, 100);
+        SSVGPathOptions Options;
+        EXPECT_TRUE(Writer.Path(Points.data(), Points.size(), Options, {{"stroke","blue"}}));
+        Options.DRelative = true;
+        Options.DPrecision = 1;
+        Options.DTolerance = 0.1;
+        SSVGStyleHandle Style = Writer.RegisterStyle({{"fill","none"}});
+        EXPECT_TRUE(Writer.Path(Points.data(), Points.size(), Options, Style));
+        EXPECT_FALSE(Writer.Path(Points.data(), 1, Options, Style));
+        EXPECT_FALSE(Writer.Path(Points.data(), Points.size(), Options, SSVGStyleHandle(5)));
+        Options.DPrecision = 16;
+        EXPECT_FALSE(Writer.Path(Points.data(), Points.size(), Options, {}));
+    }
+    EXPECT_NE(Sink->String().find("<path d=\"M10 20L10.25 19 10.5 18 30.125 40\" style=\"stroke:blue\"/>"), std::string::npos);
+    EXPECT_NE(Sink->String().find("<path d=\"M10 20l0.5-2 19.6 22\" style=\"fill:none\"/>"), std::string::npos);
+}
+
+TEST(SVGWriterTest, DecimationTest){
+    std::shared_ptr<CStringDataSink> Sink = std::make_shared<CStringDataSink>();
+    std::vector<SSVGPoint> Points;
+    for(int Index = 0; Index < 1000; Index++){
+        Points.push_back({Index / 100.0, (TSVGReal)(Index % 7)});
+    }
+    {
+        CSVGWriter Writer(Sink, 10, 10);
+        EXPECT_TRUE(Writer.SetDecimation(CSVGWriter::EDecimation::MinMax));
+        EXPECT_TRUE(Writer.SimplePath(Points, {{"stroke","black"}}));
+        EXPECT_TRUE(Writer.Path(Points.data(), Points.size(), SSVGPathOptions(), {{"stroke","red"}}));
+        EXPECT_TRUE(Writer.SetDecimation(CSVGWriter::EDecimation::LTTB));
+        EXPECT_TRUE(Writer.Path(Points.data(), Points.size(), SSVGPathOptions(), {{"stroke","blue"}}));
+        EXPECT_FALSE(Writer.SetDecimation(static_cast<CSVGWriter::EDecimation>(9)));
+    }
+    std::string Output = Sink->String();
+    std::size_t Lines = 0;
+    for(std::size_t Position = Output.find("<line"); Position != std::string::npos; Position = Output.find("<line", Position + 1)){
+        Lines++;
+    }
+    // At most the first, lowest, highest and last point of each column
+    EXPECT_EQ(Lines, 36);
+    EXPECT_NE(Output.find("<path d=\"M0 0L0.06 6 0.99 1 1 2 1.04 6 1.05 0 1.99 3"), std::string::npos);
+    EXPECT_NE(Output.find("<path d=\"M0 0L0.06 6 0.56 0 1.11 6 1.68 0 2.23 6 2.8 0 3.35 6 3.92 0 4.47 6 5.04 0 5.59 6 6.16 0 6.71 6 7.21 0 7.83 6 8.33 0 8.88 6 9.45 0 9.99 5\" style=\"stroke:blue\"/>"), std::string::npos);
 }
@@ -30,3 +30,61 @@ TEST(StringDataSink, WriteTest){
     EXPECT_TRUE(Sink.Write(TempVector2));
     EXPECT_EQ(Sink.String(),"Hello World");   
 }
+
+TEST(StringDataSink, WriteSpanTest){
+    const char *Text = "Hello World";
+    CStringDataSink Sink;
+    CDataSink &BaseSink = Sink;
+
+    EXPECT_TRUE(Sink.Write(Text, 5));
+    EXPECT_EQ(Sink.String(),"Hello");
+    EXPECT_TRUE(BaseSink.Write(Text + 5, 6));
+    EXPECT_EQ(Sink.String(),"Hello World");
+    EXPECT_TRUE(Sink.Write(Text, 0));
+    EXPECT_EQ(Sink.String(),"Hello World");
+}
+
+TEST(StringDataSink, CapacityTest){
+    CStringDataSink Sink(1024);
+    std::string Text(100,'x');
+
+    EXPECT_GE(Sink.PeakCapacity(), 1024);
+    for(int Index = 0; Index < 10; Index++){
+        EXPECT_TRUE(Sink.Write(Text.data(), Text.size()));
+    }
+    EXPECT_EQ(Sink.ReallocationCount(), 0);
+    EXPECT_EQ(Sink.String().size(), 1000);
+}
+
+TEST(StringDataSink, GrowthTest){
+    CStringDataSink Sink;
+
+    for(int Index = 0; Index < 100000; Index++){
+        EXPECT_TRUE(Sink.Put('a' + Index % 26));
+    }
+    EXPECT_EQ(Sink.String().size(), 100000);
+    EXPECT_GT(Sink.ReallocationCount(), 0);
+    EXPECT_LT(Sink.ReallocationCount(), 20);
+    EXPECT_GE(Sink.PeakCapacity(), 100000);
+    EXPECT_EQ(Sink.String()[27], 'b');
+}
+
+TEST(StringDataSink, StringViewTest){
+    CStringDataSink Sink;
+
+    EXPECT_TRUE(Sink.StringView().empty());
+    EXPECT_TRUE(Sink.Write("Hello", 5));
+    EXPECT_EQ(Sink.StringView(), "Hello");
+    EXPECT_EQ(Sink.StringView().data(), Sink.String().data());
+}
+
+TEST(StringDataSink, TakeStringTest){
+    CStringDataSink Sink(64);
+
+    EXPECT_TRUE(Sink.Write("Hello World", 11));
+    std::string Result = Sink.TakeString();
+    EXPECT_EQ(Result, "Hello World");
+    EXPECT_TRUE(Sink.String().empty());
+    EXPECT_TRUE(Sink.Put('H'));
+    EXPECT_EQ(Sink.String(), "H");
+}
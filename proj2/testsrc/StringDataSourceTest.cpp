@@ -81,3 +81,64 @@ TEST(StringDataSource, ReadTest){
     EXPECT_FALSE(Source2.Peek(TempCh));
     EXPECT_EQ(TempCh,'x');
 }
+
+TEST(StringDataSource, BulkReadTest){
+    CStringDataSource EmptySource("");
+    CStringDataSource Source("Hello World");
+    CDataSource &BaseSource = Source;
+    char Buffer[8] = {'x','x','x','x','x','x','x','x'};
+    char TempCh = 'x';
+
+    EXPECT_EQ(EmptySource.Read(Buffer,sizeof(Buffer)),0);
+    EXPECT_EQ(Buffer[0],'x');
+    EXPECT_EQ(Source.Read(Buffer,5),5);
+    EXPECT_EQ(std::string(Buffer,5),"Hello");
+    EXPECT_EQ(Buffer[5],'x');
+    EXPECT_TRUE(Source.Peek(TempCh));
+    EXPECT_EQ(TempCh,' ');
+    EXPECT_EQ(BaseSource.Read(Buffer,sizeof(Buffer)),6);
+    EXPECT_EQ(std::string(Buffer,6)," World");
+    EXPECT_EQ(Source.Read(Buffer,sizeof(Buffer)),0);
+    EXPECT_TRUE(Source.End());
+}
+
+// Source that only implements the per-character interface
+class CGetOnlySource : public CDataSource{
+    public:
+        std::string DString;
+        std::size_t DIndex = 0;
+
+        bool End() const noexcept override{
+            return DIndex >= DString.length();
+        }
+        bool Get(char &ch) noexcept override{
+            if(End()){
+                return false;
+            }
+            ch = DString[DIndex++];
+            return true;
+        }
+        bool Peek(char &ch) noexcept override{
+            if(End()){
+                return false;
+            }
+            ch = DString[DIndex];
+            return true;
+        }
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override{
+            return false;
+        }
+};
+
+TEST(StringDataSource, DefaultBulkReadTest){
+    CGetOnlySource Source;
+    CDataSource &BaseSource = Source;
+    char Buffer[4];
+
+    Source.DString = "Hello";
+    EXPECT_EQ(BaseSource.Read(Buffer,sizeof(Buffer)),4);
+    EXPECT_EQ(std::string(Buffer,4),"Hell");
+    EXPECT_EQ(BaseSource.Read(Buffer,sizeof(Buffer)),1);
+    EXPECT_EQ(Buffer[0],'o');
+    EXPECT_EQ(BaseSource.Read(Buffer,sizeof(Buffer)),0);
+}
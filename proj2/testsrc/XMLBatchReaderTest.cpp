@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "XMLBatchReader.h"
+#include "StringDataSource.h"
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+// Builds a document whose shape and size depend on index
+std::string BatchDocument(std::size_t index){
+    std::string Document = "<svg id=\"" + std::to_string(index) + "\">";
+    for(std::size_t Element = 0; Element < (index * 37) % 200 + 1; Element++){
+        Document += "<circle cx=\"" + std::to_string(Element) + "\" cy=\"" + std::to_string(index) + "\"/>text" + std::to_string(Element);
+    }
+    return Document + "</svg>";
+}
+
+std::vector< std::shared_ptr< CDataSource > > BatchSources(std::size_t count){
+    std::vector< std::shared_ptr< CDataSource > > Sources;
+    for(std::size_t Index = 0; Index < count; Index++){
+        Sources.push_back(std::make_shared<CStringDataSource>(BatchDocument(Index)));
+    }
+    return Sources;
+}
+
+// Entities of index read one at a time with a plain reader
+std::vector< SXMLEntity > SequentialEntities(std::size_t index, bool skipcdata = false){
+    CXMLReader Reader(std::make_shared<CStringDataSource>(BatchDocument(index)));
+    std::vector< SXMLEntity > Entities;
+    SXMLEntity Entity;
+    while(Reader.ReadEntity(Entity, skipcdata)){
+        Entities.push_back(Entity);
+    }
+    return Entities;
+}
+
+void ExpectSameEntities(const std::vector< SXMLEntity > &actual, const std::vector< SXMLEntity > &expected){
+    ASSERT_EQ(actual.size(), expected.size());
+    for(std::size_t Index = 0; Index < actual.size(); Index++){
+        EXPECT_EQ(actual[Index].DType, expected[Index].DType);
+        EXPECT_EQ(actual[Index].DNameData, expected[Index].DNameData);
+        EXPECT_EQ(actual[Index].DAttributes, expected[Index].DAttributes);
+    }
+}
+
+TEST(XMLBatchReaderTest, EmptyBatchTest){
+    CXMLBatchReader Reader(4);
+
+    EXPECT_EQ(Reader.ThreadCount(), 4);
+    EXPECT_TRUE(Reader.Ingest({}).empty());
+    EXPECT_GE(CXMLBatchReader().ThreadCount(), 1);
+}
+
+TEST(XMLBatchReaderTest, DocumentOrderTest){
+    const std::size_t Documents = 64;
+    std::vector< std::vector< SXMLEntity > > Expected;
+    for(std::size_t Index = 0; Index < Documents; Index++){
+        Expected.push_back(SequentialEntities(Index));
+    }
+    for(std::size_t Threads : {1, 2, 3, 8}){
+        CXMLBatchReader Reader(Threads, 64);
+        for(int Repeat = 0; Repeat < 3; Repeat++){
+            auto Results = Reader.Ingest(BatchSources(Documents));
+            ASSERT_EQ(Results.size(), Documents);
+            for(std::size_t Index = 0; Index < Documents; Index++){
+                ExpectSameEntities(Results[Index], Expected[Index]);
+            }
+        }
+    }
+}
+
+TEST(XMLBatchReaderTest, CallbackTest){
+    const std::size_t Documents = 40;
+    CXMLBatchReader Reader(4);
+    std::mutex Mutex;
+    std::vector< std::vector< std::string > > Names(Documents);
+
+    Reader.Ingest(BatchSources(Documents), [&](std::size_t document, const SXMLEntityView &entity){
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Names[document].push_back(std::string(entity.DNameData) + std::string(entity.AttributeValue("cx")));
+    }, true);
+    for(std::size_t Index = 0; Index < Documents; Index++){
+        std::vector< std::string > Expected;
+        for(auto &Entity : SequentialEntities(Index, true)){
+            Expected.push_back(Entity.DNameData + Entity.AttributeValue("cx"));
+        }
+        EXPECT_EQ(Names[Index], Expected);
+    }
+}
+
+TEST(XMLBatchReaderTest, FileTest){
+    std::vector< std::string > Paths;
+    for(std::size_t Index = 0; Index < 5; Index++){
+        Paths.push_back("xmlbatchtest" + std::to_string(Index) + ".xml");
+        std::ofstream(Paths.back()) << BatchDocument(Index);
+    }
+    CXMLBatchReader Reader(2);
+    std::mutex Mutex;
+    std::vector< std::size_t > Counts(Paths.size());
+
+    EXPECT_TRUE(Reader.IngestFiles(Paths, [&](std::size_t document, const SXMLEntityView &entity){
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Counts[document]++;
+    }));
+    for(std::size_t Index = 0; Index < Paths.size(); Index++){
+        EXPECT_EQ(Counts[Index], SequentialEntities(Index).size());
+    }
+    Paths.push_back("xmlbatchtest_missing.xml");
+    EXPECT_FALSE(Reader.IngestFiles(Paths, [](std::size_t, const SXMLEntityView &){}));
+    for(auto &Path : Paths){
+        std::remove(Path.c_str());
+    }
+}
+
+TEST(XMLBatchReaderTest, InvalidDocumentTest){
+    std::vector< std::shared_ptr< CDataSource > > Sources = BatchSources(6);
+    Sources[2] = std::make_shared<CStringDataSource>("<svg><circle></svg>");
+    Sources[4] = std::make_shared<CStringDataSource>("");
+    CXMLBatchReader Reader(3);
+
+    auto Results = Reader.Ingest(Sources);
+    ASSERT_EQ(Results.size(), 6);
+    ExpectSameEntities(Results[3], SequentialEntities(3));
+    ExpectSameEntities(Results[5], SequentialEntities(5));
+    EXPECT_TRUE(Results[4].empty());
+    ASSERT_EQ(Results[2].size(), 2);
+    EXPECT_EQ(Results[2][1].DNameData, "circle");
+}
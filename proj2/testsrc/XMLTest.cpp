@@ -1,31 +1,631 @@
 #include <gtest/gtest.h>
 #include "XMLReader.h"
+#include "XMLNameTable.h"
 #include "StringDataSource.h"
+#include <functional>
+#include <random>
+
+// Reads consecutive CharData entities and returns their combined text
+std::string ReadCharData(CXMLReader &reader, SXMLEntity &entity){
+    std::string Result;
+    while(reader.ReadEntity(entity) && entity.DType == SXMLEntity::EType::CharData){
+        Result += entity.DNameData;
+    }
+    return Result;
+}
 
 TEST(XMLReaderTest, SimpleTest){
-    FAIL() << "should fail";
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<example></example>");
+    CXMLReader Reader(Source);
+    SXMLEntity Entity;
+
+    EXPECT_FALSE(Reader.End());
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+    EXPECT_EQ(Entity.DNameData, "example");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "example");
+    EXPECT_FALSE(Reader.ReadEntity(Entity));
+    EXPECT_TRUE(Reader.End());
 }
 
 TEST(XMLReaderTest, ElementTest){
-    FAIL() << "should fail";
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<svg width=\"100\" height=\"50\"><circle cx=\"1\" cy=\"2\"/></svg>");
+    CXMLReader Reader(Source);
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+    EXPECT_EQ(Entity.DNameData, "svg");
+    ASSERT_EQ(Entity.DAttributes.size(), 2);
+    EXPECT_EQ(Entity.AttributeValue("width"), "100");
+    EXPECT_EQ(Entity.AttributeValue("height"), "50");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+    EXPECT_EQ(Entity.DNameData, "circle");
+    EXPECT_EQ(Entity.AttributeValue("cx"), "1");
+    EXPECT_EQ(Entity.AttributeValue("cy"), "2");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "circle");
+    EXPECT_TRUE(Entity.DAttributes.empty());
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "svg");
+    EXPECT_FALSE(Reader.ReadEntity(Entity));
 }
 
 TEST(XMLReaderTest, CDataTest){
-    FAIL() << "should fail";
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<text>Hello World</text>");
+    CXMLReader Reader(Source);
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+    EXPECT_EQ(ReadCharData(Reader, Entity), "Hello World");
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "text");
+
+    std::shared_ptr<CStringDataSource> SkipSource = std::make_shared<CStringDataSource>("<text>Hello<b>World</b></text>");
+    CXMLReader SkipReader(SkipSource);
+    std::vector<std::string> Names;
+    while(SkipReader.ReadEntity(Entity, true)){
+        EXPECT_NE(Entity.DType, SXMLEntity::EType::CharData);
+        Names.push_back(Entity.DNameData);
+    }
+    EXPECT_EQ(Names, std::vector<std::string>({"text", "b", "b", "text"}));
 }
 
 TEST(XMLReaderTest, LongCDataTest){
-    FAIL() << "should fail";
+    std::string Text(100000, 'x');
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<text>" + Text + "</text>");
+    CXMLReader Reader(Source, 4096);
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(ReadCharData(Reader, Entity), Text);
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_FALSE(Reader.ReadEntity(Entity));
 }
 
 TEST(XMLReaderTest, SpecialCharacterTest){
-    FAIL() << "should fail";
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<text a=\"&lt;&quot;&gt;\">&amp;&lt;&gt;&apos;&quot;&#65;</text>");
+    CXMLReader Reader(Source);
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.AttributeValue("a"), "<\">");
+    EXPECT_EQ(ReadCharData(Reader, Entity), "&<>'\"A");
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
 }
 
 TEST(XMLReaderTest, InvalidXMLTest){
-    FAIL() << "should fail";
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<a><b></a>");
+    CXMLReader Reader(Source);
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "a");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "b");
+    EXPECT_FALSE(Reader.ReadEntity(Entity));
+    EXPECT_TRUE(Reader.End());
+
+    std::shared_ptr<CStringDataSource> TruncatedSource = std::make_shared<CStringDataSource>("<a><b>");
+    CXMLReader TruncatedReader(TruncatedSource);
+    ASSERT_TRUE(TruncatedReader.ReadEntity(Entity));
+    ASSERT_TRUE(TruncatedReader.ReadEntity(Entity));
+    EXPECT_FALSE(TruncatedReader.ReadEntity(Entity));
 }
 
 TEST(XMLReaderTest, LongCharDataCrosses512Boundary){
-    FAIL() << "should fail";
+    std::string Text;
+    for(int Index = 0; Index < 1000; Index++){
+        Text += (char)('a' + Index % 26);
+    }
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<text>" + Text + "</text>");
+    CXMLReader Reader(Source, 512);
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::CharData);
+    EXPECT_EQ(Entity.DNameData, Text);
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "text");
+}
+
+TEST(XMLReaderTest, CoalesceCharDataTest){
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<text>a&amp;b\nc&#65;<b/>d</text>");
+    CXMLReader Reader(Source, 3);
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::CharData);
+    EXPECT_EQ(Entity.DNameData, "a&b\ncA");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::CharData);
+    EXPECT_EQ(Entity.DNameData, "d");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+}
+
+TEST(XMLReaderTest, MaxCharDataTest){
+    std::string Text(2500, 'x');
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<text>" + Text + "</text>");
+    CXMLReader Reader(Source, 512, 1000);
+    SXMLEntity Entity;
+    std::vector<std::size_t> Lengths;
+
+    while(Reader.ReadEntity(Entity)){
+        if(Entity.DType == SXMLEntity::EType::CharData){
+            Lengths.push_back(Entity.DNameData.size());
+        }
+    }
+    EXPECT_EQ(Lengths, std::vector<std::size_t>({1000, 1000, 500}));
+}
+
+TEST(XMLReaderTest, ChunkSizeTest){
+    std::string Document = "<svg>";
+    for(int Index = 0; Index < 1000; Index++){
+        Document += "<circle cx=\"" + std::to_string(Index) + "\"/>";
+    }
+    Document += "</svg>";
+    for(std::size_t ChunkSize : {1, 7, 512, 65536}){
+        std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>(Document);
+        CXMLReader Reader(Source, ChunkSize);
+        SXMLEntity Entity;
+        int Circles = 0;
+        while(Reader.ReadEntity(Entity)){
+            if(Entity.DType == SXMLEntity::EType::StartElement && Entity.DNameData == "circle"){
+                EXPECT_EQ(Entity.AttributeValue("cx"), std::to_string(Circles));
+                Circles++;
+            }
+        }
+        EXPECT_EQ(Circles, 1000);
+        EXPECT_TRUE(Reader.End());
+    }
+}
+
+TEST(XMLReaderTest, EntityViewTest){
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<svg width=\"100\"><text x=\"1\" y=\"2\">Hi &amp; bye</text></svg>");
+    CXMLReader Reader(Source);
+    SXMLEntityView Entity;
+
+    ASSERT_TRUE(Reader.ReadEntityView(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+    EXPECT_EQ(Entity.DNameData, "svg");
+    EXPECT_TRUE(Entity.AttributeExists("width"));
+    EXPECT_EQ(Entity.AttributeValue("width"), "100");
+    EXPECT_FALSE(Entity.AttributeExists("height"));
+    EXPECT_TRUE(Entity.AttributeValue("height").empty());
+    ASSERT_TRUE(Reader.ReadEntityView(Entity));
+    EXPECT_EQ(Entity.DNameData, "text");
+    ASSERT_EQ(Entity.DAttributes.size(), 2);
+    EXPECT_EQ(Entity.DAttributes[0], TAttributeView("x", "1"));
+    EXPECT_EQ(Entity.DAttributes[1], TAttributeView("y", "2"));
+    ASSERT_TRUE(Reader.ReadEntityView(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::CharData);
+    EXPECT_EQ(Entity.DNameData, "Hi & bye");
+    EXPECT_TRUE(Entity.DAttributes.empty());
+    ASSERT_TRUE(Reader.ReadEntityView(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "text");
+    ASSERT_TRUE(Reader.ReadEntityView(Entity));
+    EXPECT_EQ(Entity.DNameData, "svg");
+    EXPECT_FALSE(Reader.ReadEntityView(Entity));
+    EXPECT_TRUE(Reader.End());
+}
+
+TEST(XMLReaderTest, MixedReadTest){
+    std::string Document = "<svg>";
+    for(int Index = 0; Index < 500; Index++){
+        Document += "<circle cx=\"" + std::to_string(Index) + "\"/>";
+    }
+    Document += "</svg>";
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>(Document);
+    CXMLReader Reader(Source, 100);
+    SXMLEntity Entity;
+    SXMLEntityView EntityView;
+    int Circles = 0;
+
+    for(bool UseView = false; ; UseView = !UseView){
+        std::string Name, Value;
+        if(UseView){
+            if(!Reader.ReadEntityView(EntityView)){
+                break;
+            }
+            Name = std::string(EntityView.DNameData);
+            Value = std::string(EntityView.AttributeValue("cx"));
+        }
+        else{
+            if(!Reader.ReadEntity(Entity)){
+                break;
+            }
+            Name = Entity.DNameData;
+            Value = Entity.AttributeValue("cx");
+        }
+        if(Name == "circle" && !Value.empty()){
+            EXPECT_EQ(Value, std::to_string(Circles));
+            Circles++;
+        }
+    }
+    EXPECT_EQ(Circles, 500);
+}
+
+TEST(XMLReaderTest, NameTableTest){
+    CXMLNameTable Names;
+    CXMLNameTable EmptyNames(false);
+
+    EXPECT_GT(Names.Size(), 0);
+    EXPECT_EQ(EmptyNames.Size(), 0);
+    TXMLNameID CircleID = Names.Find("circle");
+    EXPECT_NE(CircleID, InvalidXMLNameID);
+    EXPECT_EQ(Names.Name(CircleID), "circle");
+    EXPECT_EQ(Names.Stats().DLookups, 0);
+    EXPECT_EQ(Names.Intern("circle"), CircleID);
+    EXPECT_EQ(Names.Find("custom"), InvalidXMLNameID);
+    TXMLNameID CustomID = Names.Intern("custom");
+    EXPECT_NE(CustomID, InvalidXMLNameID);
+    EXPECT_EQ(Names.Intern(std::string("custom")), CustomID);
+    EXPECT_EQ(Names.Name(CustomID), "custom");
+    EXPECT_TRUE(Names.Name(InvalidXMLNameID).empty());
+
+    CXMLNameTable::SStats Stats = Names.Stats();
+    EXPECT_EQ(Stats.DSize, Names.Size());
+    EXPECT_EQ(Stats.DLookups, 3);
+    EXPECT_EQ(Stats.DHits, 2);
+    EXPECT_DOUBLE_EQ(Stats.HitRate(), 2.0 / 3.0);
+    EXPECT_DOUBLE_EQ(EmptyNames.Stats().HitRate(), 0.0);
+}
+
+TEST(XMLReaderTest, InternedNameTest){
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>("<svg><circle cx=\"1\" r=\"2\"/><widget cx=\"3\" knob=\"4\">text</widget></svg>");
+    CXMLReader Reader(Source);
+    SXMLEntityView Entity;
+    CXMLNameTable &Names = Reader.NameTable();
+    TXMLNameID CircleID = Names.Find("circle");
+    TXMLNameID CXID = Names.Find("cx");
+
+    ASSERT_TRUE(Reader.ReadEntityView(Entity));
+    EXPECT_EQ(Entity.DNameID, Names.Find("svg"));
+    ASSERT_TRUE(Reader.ReadEntityView(Entity));
+    EXPECT_EQ(Entity.DNameID, CircleID);
+    EXPECT_EQ(Entity.DNameData, "circle");
+    ASSERT_EQ(Entity.DAttributeIDs.size(), 2);
+    EXPECT_EQ(Entity.DAttributeIDs[0], CXID);
+    EXPECT_TRUE(Entity.AttributeExists(CXID));
+    EXPECT_EQ(Entity.AttributeValue(CXID), "1");
+    EXPECT_EQ(Entity.AttributeValue(Names.Find("r")), "2");
+    EXPECT_FALSE(Entity.AttributeExists(Names.Find("cy")));
+    ASSERT_TRUE(Reader.ReadEntityView(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameID, CircleID);
+    ASSERT_TRUE(Reader.ReadEntityView(Entity));
+    TXMLNameID WidgetID = Names.Find("widget");
+    EXPECT_NE(WidgetID, InvalidXMLNameID);
+    EXPECT_EQ(Entity.DNameID, WidgetID);
+    EXPECT_EQ(Entity.AttributeValue(CXID), "3");
+    EXPECT_EQ(Entity.AttributeValue(Names.Find("knob")), "4");
+    ASSERT_TRUE(Reader.ReadEntityView(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::CharData);
+    EXPECT_EQ(Entity.DNameID, InvalidXMLNameID);
+    EXPECT_EQ(Entity.DNameData, "text");
+    while(Reader.ReadEntityView(Entity));
+
+    CXMLNameTable::SStats Stats = Names.Stats();
+    EXPECT_EQ(Stats.DLookups, 10);
+    EXPECT_EQ(Stats.DHits, 8);
+}
+
+TEST(XMLEntityTest, AttributeTest){
+    SXMLEntity Entity;
+
+    EXPECT_FALSE(Entity.AttributeExists("a"));
+    EXPECT_TRUE(Entity.AttributeValue("a").empty());
+    EXPECT_FALSE(Entity.SetAttribute("", "x"));
+    EXPECT_TRUE(Entity.SetAttribute("a", "1"));
+    EXPECT_TRUE(Entity.SetAttribute("b", "2"));
+    EXPECT_TRUE(Entity.SetAttribute("a", "3"));
+    ASSERT_EQ(Entity.DAttributes.size(), 2);
+    EXPECT_EQ(Entity.DAttributes[0], TAttribute("a", "3"));
+    EXPECT_EQ(Entity.DAttributes[1], TAttribute("b", "2"));
+    EXPECT_EQ(Entity.AttributeValue("a"), "3");
+    EXPECT_EQ(Entity.DAttributes.Find("c"), nullptr);
+    ASSERT_NE(Entity.DAttributes.Find("b"), nullptr);
+    EXPECT_EQ(*Entity.DAttributes.Find("b"), "2");
+    EXPECT_EQ(Entity.DAttributes, CXMLAttributes({{"a", "3"}, {"b", "2"}}));
+}
+
+TEST(XMLEntityTest, IndexedAttributeTest){
+    SXMLEntity Entity;
+    std::size_t Count = CXMLAttributes::IndexThreshold * 10;
+
+    for(std::size_t Index = 0; Index < Count; Index++){
+        EXPECT_TRUE(Entity.SetAttribute("attr" + std::to_string(Index), std::to_string(Index)));
+    }
+    for(std::size_t Index = 0; Index < Count; Index += 3){
+        EXPECT_TRUE(Entity.SetAttribute("attr" + std::to_string(Index), "x" + std::to_string(Index)));
+    }
+    ASSERT_EQ(Entity.DAttributes.size(), Count);
+    std::size_t Index = 0;
+    for(auto &Attribute : Entity.DAttributes){
+        EXPECT_EQ(Attribute.first, "attr" + std::to_string(Index));
+        EXPECT_EQ(Entity.AttributeValue(Attribute.first), Index % 3 ? std::to_string(Index) : "x" + std::to_string(Index));
+        Index++;
+    }
+    EXPECT_FALSE(Entity.AttributeExists("attr"));
+    EXPECT_FALSE(Entity.AttributeExists("attr" + std::to_string(Count)));
+    Entity.DAttributes.clear();
+    EXPECT_TRUE(Entity.DAttributes.empty());
+    EXPECT_FALSE(Entity.AttributeExists("attr0"));
+    Entity.DAttributes.push_back(TAttribute("attr0", "y"));
+    EXPECT_EQ(Entity.AttributeValue("attr0"), "y");
+}
+
+TEST(XMLReaderTest, WideElementTest){
+    std::string Document = "<wide";
+    for(int Index = 0; Index < 64; Index++){
+        Document += " a" + std::to_string(Index) + "=\"" + std::to_string(Index * 2) + "\"";
+    }
+    Document += "/>";
+    std::shared_ptr<CStringDataSource> Source = std::make_shared<CStringDataSource>(Document);
+    CXMLReader Reader(Source);
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    ASSERT_EQ(Entity.DAttributes.size(), 64);
+    for(int Index = 63; Index >= 0; Index--){
+        EXPECT_EQ(Entity.AttributeValue("a" + std::to_string(Index)), std::to_string(Index * 2));
+    }
+}
+
+TEST(XMLReaderTest, ResetTest){
+    CXMLReader Reader(std::make_shared<CStringDataSource>("<a><b/>"), 4);
+    SXMLEntity Entity;
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "a");
+    Reader.Reset(std::make_shared<CStringDataSource>("<c x=\"1\">text</c>"));
+    EXPECT_FALSE(Reader.End());
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "c");
+    EXPECT_EQ(Entity.AttributeValue("x"), "1");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "text");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_FALSE(Reader.ReadEntity(Entity));
+    EXPECT_TRUE(Reader.End());
+    EXPECT_NE(Reader.NameTable().Find("c"), InvalidXMLNameID);
+    Reader.Reset(std::make_shared<CStringDataSource>("<d/>"));
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "d");
+}
+
+// A document of at least kilobytes KB made of sibling elements under one
+// group, with middle inserted two thirds of the way through
+std::string SiblingDocument(std::size_t kilobytes, const std::string &prolog = "", const std::string &middle = ""){
+    std::string Document = prolog + "<svg width=\"100\" height=\"100\">\n<g style=\"fill:red\">";
+    std::size_t Target = kilobytes << 10;
+    bool Inserted = false;
+    for(std::size_t Index = 0; Document.size() < Target; Index++){
+        if(!Inserted && Document.size() > Target * 2 / 3){
+            Document += middle;
+            Inserted = true;
+        }
+        if(Index % 5 == 0){
+            Document += "<text x=\"" + std::to_string(Index) + "\">label &amp; " + std::to_string(Index) + "</text>\n";
+        }
+        else if(Index % 7 == 0){
+            Document += "<!-- comment " + std::to_string(Index) + " --><rect x=\"1\" y=\"2\" width=\"3\" height=\"4\"/>\n";
+        }
+        else{
+            Document += "<circle cx=\"" + std::to_string(Index) + "\" cy=\"" + std::to_string(Index % 97) + "\" r=\"2\"/>\n";
+        }
+    }
+    return Document + "</g>\n</svg>\n";
+}
+
+// Entities of document read with the given thread count, flattened to text
+std::vector<std::string> ReadAllEntities(const std::string &document, std::size_t threads, bool skipcdata = false, std::size_t chunksize = 1024, std::size_t maxchardata = 0, bool fasttokenizer = false){
+    CXMLReader Reader(std::make_shared<CStringDataSource>(document), chunksize, maxchardata, threads, fasttokenizer);
+    std::vector<std::string> Entities;
+    SXMLEntityView Entity;
+    bool NamesMatch = true;
+    while(Reader.ReadEntityView(Entity, skipcdata)){
+        std::string Text = std::to_string(int(Entity.DType)) + std::string(Entity.DNameData);
+        for(std::size_t Index = 0; Index < Entity.DAttributes.size(); Index++){
+            Text += " " + std::string(std::get<0>(Entity.DAttributes[Index])) + "=" + std::string(std::get<1>(Entity.DAttributes[Index]));
+            NamesMatch = NamesMatch && Reader.NameTable().Name(Entity.DAttributeIDs[Index]) == std::get<0>(Entity.DAttributes[Index]);
+        }
+        NamesMatch = NamesMatch && (Entity.DNameID == InvalidXMLNameID || Reader.NameTable().Name(Entity.DNameID) == Entity.DNameData);
+        Entities.push_back(Text);
+    }
+    EXPECT_TRUE(NamesMatch);
+    EXPECT_TRUE(Reader.End());
+    return Entities;
+}
+
+TEST(XMLReaderTest, ParallelTest){
+    std::string Document = SiblingDocument(400, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    for(bool SkipCData : {false, true}){
+        std::vector<std::string> Expected = ReadAllEntities(Document, 1, SkipCData);
+        for(std::size_t Threads : {2, 3, 8}){
+            EXPECT_EQ(ReadAllEntities(Document, Threads, SkipCData), Expected);
+        }
+    }
+    // Default chunk size, split into a single round
+    EXPECT_EQ(ReadAllEntities(SiblingDocument(1100), 4, false, CXMLReader::DefaultChunkSize), ReadAllEntities(SiblingDocument(1100), 1));
+}
+
+TEST(XMLReaderTest, ParallelOwningTest){
+    std::string Document = SiblingDocument(200);
+    CXMLReader Sequential(std::make_shared<CStringDataSource>(Document));
+    CXMLReader Parallel(std::make_shared<CStringDataSource>(Document), 1024, 0, 4);
+    SXMLEntity Expected, Entity;
+
+    while(Sequential.ReadEntity(Expected)){
+        ASSERT_TRUE(Parallel.ReadEntity(Entity));
+        EXPECT_EQ(Entity.DType, Expected.DType);
+        EXPECT_EQ(Entity.DNameData, Expected.DNameData);
+        EXPECT_EQ(Entity.DAttributes, Expected.DAttributes);
+    }
+    EXPECT_FALSE(Parallel.ReadEntity(Entity));
+    EXPECT_TRUE(Parallel.End());
+}
+
+TEST(XMLReaderTest, ParallelFallbackTest){
+    std::string Filler(20000, 'x');
+    std::vector<std::string> Documents = {
+        // Large comment and CDATA sections holding tags
+        SiblingDocument(300, "", "<!-- " + Filler + "<circle cx=\"5\"/>" + Filler + " -->"),
+        SiblingDocument(300, "", "<text><![CDATA[" + Filler + "<circle cx=\"5\"/>" + Filler + "]]></text>"),
+        SiblingDocument(300, "", "<?pi " + Filler + "<circle cx=\"5\"/>" + Filler + "?>"),
+        // Attribute value holding a tag like sequence
+        SiblingDocument(300, "", "<desc title=\"" + Filler + "&lt;circle/>" + Filler + "\"/>"),
+        // Siblings that are not at a single level
+        SiblingDocument(300, "", "</g><g>" + SiblingDocument(50) + "</g><g>"),
+        // Entities declared in a DTD
+        SiblingDocument(300, "<!DOCTYPE svg [<!ENTITY e \"expanded\">]>\n", "<text>&e;</text>"),
+        // Parse errors part way through
+        SiblingDocument(300, "", "<circle></rect>"),
+        SiblingDocument(300, "", "<circle"),
+        SiblingDocument(300).substr(0, 200000)
+    };
+    for(auto &Document : Documents){
+        EXPECT_EQ(ReadAllEntities(Document, 2), ReadAllEntities(Document, 1));
+        EXPECT_EQ(ReadAllEntities(Document, 3, true), ReadAllEntities(Document, 1, true));
+    }
+}
+
+// Random document built from the constructs the fast tokenizer handles and
+// ones it must hand to expat, optionally damaged afterwards
+std::string FuzzDocument(std::mt19937 &random){
+    static const std::vector<std::string> Prologs = {"", "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n", "<?xml version='1.0'?>", "<?xml version=\"1.0\" standalone=\"yes\"?>",
+        "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>", "<?xml-stylesheet href=\"a.css\"?>\n", "<!-- c -->", "<!DOCTYPE svg>", " ", "<?XML version=\"1.0\"?>"};
+    static const std::vector<std::string> Names = {"svg", "g", "circle", "rect", "a:b", "_x", "t-1.2"};
+    static const std::vector<std::string> ValueParts = {"12", "3.5", "fill:red", "&amp;", "&lt;", "&#65;", "&#x263A;", "&#x1F600;", "&#10;", "\t", "\n", " ", ">", "&quot;", "&apos;"};
+    static const std::vector<std::string> TextParts = {"hello", " ", "\n", "\t", "&amp;", "&#10;", "&#13;", "]", "]]", ">", "]]&gt;", "&gt;", "<!-- note -->", "<![CDATA[a<b>&]]>", "<![CDATA[]]>", "<?pi data?>", "<?pi?>"};
+    static const std::vector<std::string> Damage = {"<", ">", "&", "\"", "'", "\r", "\r\n", std::string(1, '\x01'), "\xC3\xA9", "]]>", "--", " ", "&bogus;", "&#0;", "&#xD800;", "<!DOCTYPE x>", "<?xml version=\"1.0\"?>", "</g>", "<g>", "/"};
+    auto Pick = [&random](const std::vector<std::string> &choices) -> const std::string &{
+        return choices[random() % choices.size()];
+    };
+    std::function<std::string(int)> Element = [&](int depth) -> std::string{
+        std::string Name = Pick(Names);
+        std::string Result = "<" + Name;
+        std::vector<std::string> Used;
+        for(int Index = random() % 4; Index > 0; Index--){
+            std::string Attribute = "a" + std::to_string(random() % 5);
+            if(std::find(Used.begin(), Used.end(), Attribute) != Used.end()){
+                continue;
+            }
+            Used.push_back(Attribute);
+            char Quote = random() % 2 ? '"' : '\'';
+            Result += (random() % 4 ? " " : "\n\t") + Attribute + (random() % 5 ? "=" : " = ") + Quote;
+            for(int Part = random() % 4; Part > 0; Part--){
+                Result += Pick(ValueParts);
+            }
+            Result += Quote;
+        }
+        if(depth > 3 || random() % 4 == 0){
+            return Result + (random() % 2 ? "/>" : " />");
+        }
+        Result += ">";
+        for(int Child = random() % 6; Child > 0; Child--){
+            Result += random() % 2 ? Pick(TextParts) : Element(depth + 1);
+        }
+        return Result + "</" + Name + (random() % 4 ? ">" : " >");
+    };
+    std::string Document = Pick(Prologs) + Element(0) + (random() % 3 ? "\n" : "<!-- end -->\n");
+    if(random() % 3 == 0){
+        std::size_t Position = random() % (Document.size() + 1);
+        switch(random() % 3){
+            case 0:
+                Document.insert(Position, Pick(Damage));
+                break;
+            case 1:
+                Document.erase(Position, 1);
+                break;
+            default:
+                Document.resize(Position);
+                break;
+        }
+    }
+    return Document;
+}
+
+TEST(XMLReaderTest, FastTokenizerFuzzTest){
+    std::mt19937 Random(36);
+    for(int Iteration = 0; Iteration < 3000; Iteration++){
+        std::string Document = FuzzDocument(Random);
+        std::size_t ChunkSize = std::vector<std::size_t>{1, 7, 64, 65536}[Random() % 4];
+        std::size_t MaxCharData = Random() % 3 ? 0 : 3;
+        bool SkipCData = Random() % 4 == 0;
+        ASSERT_EQ(ReadAllEntities(Document, 1, SkipCData, ChunkSize, MaxCharData, true), ReadAllEntities(Document, 1, SkipCData, ChunkSize, MaxCharData, false)) << Document;
+    }
+}
+
+TEST(XMLReaderTest, FastTokenizerTest){
+    std::string Document = SiblingDocument(300, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    EXPECT_EQ(ReadAllEntities(Document, 1, false, 4096, 0, true), ReadAllEntities(Document, 1, false, 4096));
+    EXPECT_EQ(ReadAllEntities(Document, 1, true, 65536, 5, true), ReadAllEntities(Document, 1, true, 65536, 5));
+    // Unsupported input late in the document, after entities were returned
+    Document.insert(Document.size() * 3 / 4, "<text>caf\xC3\xA9</text>");
+    EXPECT_EQ(ReadAllEntities(Document, 1, false, 4096, 0, true), ReadAllEntities(Document, 1, false, 4096));
+
+    CXMLReader Reader(std::make_shared<CStringDataSource>("<svg><circle cx=\"1\"/>text</svg>"), 65536, 0, 1, true);
+    SXMLEntity Entity;
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "svg");
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.AttributeValue("cx"), "1");
+    EXPECT_FALSE(Reader.End());
+    while(Reader.ReadEntity(Entity));
+    EXPECT_TRUE(Reader.End());
+}
+
+TEST(XMLEntityTest, ParseRealTest){
+    double Value = -1;
+    EXPECT_TRUE(XMLParseReal("12.5", Value));
+    EXPECT_EQ(Value, 12.5);
+    EXPECT_TRUE(XMLParseReal(" -3e2 ", Value));
+    EXPECT_EQ(Value, -300.0);
+    EXPECT_TRUE(XMLParseReal("+.5", Value));
+    EXPECT_EQ(Value, 0.5);
+    Value = 7;
+    EXPECT_FALSE(XMLParseReal("", Value));
+    EXPECT_FALSE(XMLParseReal("  ", Value));
+    EXPECT_FALSE(XMLParseReal("1px", Value));
+    EXPECT_FALSE(XMLParseReal("+-1", Value));
+    EXPECT_FALSE(XMLParseReal("inf", Value));
+    EXPECT_FALSE(XMLParseReal("nan", Value));
+    EXPECT_EQ(Value, 7.0);
+}
+
+TEST(XMLReaderTest, TryGetRealTest){
+    CXMLReader Reader(std::make_shared<CStringDataSource>("<circle cx=\"4.25\" cy=\"x\"/>"));
+    SXMLEntityView View;
+    double Value = 0;
+
+    ASSERT_TRUE(Reader.ReadEntityView(View));
+    EXPECT_TRUE(View.TryGetReal("cx", Value));
+    EXPECT_EQ(Value, 4.25);
+    EXPECT_FALSE(View.TryGetReal("cy", Value));
+    EXPECT_FALSE(View.TryGetReal("r", Value));
+    EXPECT_TRUE(View.TryGetReal(Reader.NameTable().Find("cx"), Value));
+    EXPECT_EQ(Value, 4.25);
+
+    SXMLEntity Entity;
+    Entity.SetAttribute("r", "2");
+    EXPECT_TRUE(Entity.TryGetReal("r", Value));
+    EXPECT_EQ(Value, 2.0);
+    EXPECT_FALSE(Entity.TryGetReal("x", Value));
 }